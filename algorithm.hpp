@@ -0,0 +1,258 @@
+#ifndef ALGORITHM_HPP
+# define ALGORITHM_HPP
+
+# include <algorithm>
+# include <functional>
+# include "vector.hpp"
+# include "./utils/utils.hpp"
+# include "./utils/parallel.hpp"
+
+namespace ft
+{
+	/* sorts the runs [bounds[i], bounds[i + 1]) */
+	template <class T, class Compare>
+	struct sort_runs_task
+	{
+		T*					_data;
+		const std::size_t*	_bounds;
+		Compare				_comp;
+
+		void operator()(std::size_t i)
+		{
+			std::stable_sort(_data + _bounds[i], _data + _bounds[i + 1], _comp);
+		}
+	};
+
+/*
+* One merge round: run groups of `width` runs are merged pairwise from src
+* into dst. Each pair is cut into `parts` equal slices of output; a slice
+* finds where it starts in both inputs by binary search (merge path), so
+* every thread has work even when only one pair is left.
+*/
+	template <class T, class Compare>
+	struct merge_round_task
+	{
+		const T*			_src;
+		T*					_dst;
+		const std::size_t*	_bounds;
+		std::size_t			_runs;
+		std::size_t			_width;
+		std::size_t			_parts;
+		Compare				_comp;
+
+		/* elements taken from a among the first k of merge(a, b), ties go to a */
+		std::size_t _corank(std::size_t k, const T* a, std::size_t na, const T* b, std::size_t nb) const
+		{
+			std::size_t lo = k > nb ? k - nb : 0;
+			std::size_t hi = k < na ? k : na;
+			while (lo < hi)
+			{
+				std::size_t i = lo + (hi - lo) / 2;
+				std::size_t j = k - i;
+				if (j > 0 && i < na && !_comp(b[j - 1], a[i]))
+					lo = i + 1;
+				else
+					hi = i;
+			}
+			return lo;
+		}
+
+		void operator()(std::size_t task)
+		{
+			std::size_t pair = task / _parts;
+			std::size_t part = task % _parts;
+			std::size_t first = 2 * _width * pair;
+			std::size_t mid = first + _width < _runs ? first + _width : _runs;
+			std::size_t last = first + 2 * _width < _runs ? first + 2 * _width : _runs;
+			const T* a = _src + _bounds[first];
+			const T* b = _src + _bounds[mid];
+			std::size_t na = _bounds[mid] - _bounds[first];
+			std::size_t nb = _bounds[last] - _bounds[mid];
+			std::size_t k0 = (na + nb) * part / _parts;
+			std::size_t k1 = (na + nb) * (part + 1) / _parts;
+			std::size_t i0 = _corank(k0, a, na, b, nb);
+			std::size_t i1 = _corank(k1, a, na, b, nb);
+			std::merge(a + i0, a + i1, b + (k0 - i0), b + (k1 - i1), _dst + _bounds[first] + k0, _comp);
+		}
+	};
+
+/*
+* Parallel merge sort, stable: runs sorted concurrently, then log2(runs)
+* merge rounds that each use every thread. Needs one copy of v as buffer.
+* threads == 0 means hardware_threads(). If comp or a copy throws, v is left
+* valid in an unspecified order and parallel_for rethrows.
+*/
+	template <class T, class Alloc, class Compare>
+	typename ft::enable_if<!ft::is_integral<Compare>::value>::type
+	parallel_sort(vector<T, Alloc>& v, Compare comp, unsigned threads = 0)
+	{
+		std::size_t n = v.size();
+		if (n < 2)
+			return ;
+		if (threads == 0)
+			threads = hardware_threads();
+		std::size_t runs = 1;
+		while (runs < threads && n / (2 * runs) >= 4096)
+			runs *= 2;
+		if (runs == 1)
+		{
+			std::stable_sort(&v[0], &v[0] + n, comp);
+			return ;
+		}
+		vector<std::size_t> bounds(runs + 1);
+		for (std::size_t i = 0; i <= runs; i++)
+			bounds[i] = n * i / runs;
+
+		sort_runs_task<T, Compare> sort_task = { &v[0], &bounds[0], comp };
+		parallel_for(runs, sort_task, threads);
+
+		vector<T, Alloc> buf(v);
+		T* src = &v[0];
+		T* dst = &buf[0];
+		for (std::size_t width = 1; width < runs; width *= 2)
+		{
+			std::size_t pairs = (runs + 2 * width - 1) / (2 * width);
+			std::size_t parts = (threads + pairs - 1) / pairs;
+			merge_round_task<T, Compare> merge_task = { src, dst, &bounds[0], runs, width, parts, comp };
+			parallel_for(pairs * parts, merge_task, threads);
+			std::swap(src, dst);
+		}
+		if (src != &v[0])
+			v.swap(buf);
+	}
+
+	/* digit of the key with the sign bit flipped, so signed order is unsigned order */
+	template <class T>
+	unsigned radix_digit(T x, unsigned shift)
+	{
+		unsigned long long u = static_cast<unsigned long long>(x);
+		if (T(-1) < T(0))
+			u ^= 1ULL << (sizeof(T) * 8 - 1);
+		return static_cast<unsigned>(u >> shift) & 255;
+	}
+
+	/* histogram of one 8-bit digit per run */
+	template <class T>
+	struct radix_count_task
+	{
+		const T*			_src;
+		const std::size_t*	_bounds;
+		std::size_t*		_counts;
+		unsigned			_shift;
+
+		void operator()(std::size_t r)
+		{
+			std::size_t* count = _counts + 256 * r;
+			for (std::size_t i = _bounds[r]; i < _bounds[r + 1]; i++)
+				++count[radix_digit(_src[i], _shift)];
+		}
+	};
+
+	/* stable scatter of one run, _counts now holds each run's write offsets */
+	template <class T>
+	struct radix_scatter_task
+	{
+		const T*			_src;
+		T*					_dst;
+		const std::size_t*	_bounds;
+		std::size_t*		_counts;
+		unsigned			_shift;
+
+		void operator()(std::size_t r)
+		{
+			std::size_t* offset = _counts + 256 * r;
+			for (std::size_t i = _bounds[r]; i < _bounds[r + 1]; i++)
+				_dst[offset[radix_digit(_src[i], _shift)]++] = _src[i];
+		}
+	};
+
+/*
+* Parallel LSD radix sort for integral types, one pass per byte: per-run
+* histograms, a prefix sum over (digit, run), then a stable scatter.
+* Passes where every key has the same digit are skipped.
+*/
+	template <class T, class Alloc>
+	void parallel_radix_sort(vector<T, Alloc>& v, unsigned threads = 0)
+	{
+		std::size_t n = v.size();
+		if (n < 2)
+			return ;
+		if (threads == 0)
+			threads = hardware_threads();
+		std::size_t runs = threads < n / 4096 ? threads : n / 4096;
+		if (runs == 0)
+			runs = 1;
+		vector<std::size_t> bounds(runs + 1);
+		for (std::size_t i = 0; i <= runs; i++)
+			bounds[i] = n * i / runs;
+		vector<std::size_t> counts(256 * runs);
+		vector<T, Alloc> buf(n);
+		T* src = &v[0];
+		T* dst = &buf[0];
+		for (unsigned shift = 0; shift < sizeof(T) * 8; shift += 8)
+		{
+			std::fill(&counts[0], &counts[0] + counts.size(), std::size_t(0));
+			radix_count_task<T> count_task = { src, &bounds[0], &counts[0], shift };
+			parallel_for(runs, count_task, threads);
+			std::size_t sum = 0;
+			bool skip = false;
+			for (std::size_t d = 0; d < 256 && !skip; d++)
+			{
+				std::size_t total = 0;
+				for (std::size_t r = 0; r < runs; r++)
+				{
+					std::size_t c = counts[256 * r + d];
+					counts[256 * r + d] = sum;
+					sum += c;
+					total += c;
+				}
+				skip = total == n;
+			}
+			if (skip)
+				continue ;
+			radix_scatter_task<T> scatter_task = { src, dst, &bounds[0], &counts[0], shift };
+			parallel_for(runs, scatter_task, threads);
+			std::swap(src, dst);
+		}
+		if (src != &v[0])
+			v.swap(buf);
+	}
+
+	template <class T, class Alloc>
+	typename ft::enable_if<ft::is_integral<T>::value>::type
+	parallel_sort(vector<T, Alloc>& v, unsigned threads = 0)
+	{
+		parallel_radix_sort(v, threads);
+	}
+
+	template <class T, class Alloc>
+	typename ft::enable_if<!ft::is_integral<T>::value>::type
+	parallel_sort(vector<T, Alloc>& v, unsigned threads = 0)
+	{
+		parallel_sort(v, std::less<T>(), threads);
+	}
+
+/*
+* vector<bool> has no T* to sort through: count the set bits a word at a
+* time and refill, false first unless comp(true, false). threads is unused.
+*/
+	template <class Alloc, class Compare>
+	typename ft::enable_if<!ft::is_integral<Compare>::value>::type
+	parallel_sort(vector<bool, Alloc>& v, Compare comp, unsigned threads = 0)
+	{
+		(void)threads;
+		std::size_t n = v.size();
+		std::size_t ones = v.count();
+		bool first = comp(true, false);
+		v.assign(first ? ones : n - ones, first);
+		v.resize(n, !first);
+	}
+
+	template <class Alloc>
+	void parallel_sort(vector<bool, Alloc>& v, unsigned threads = 0)
+	{
+		parallel_sort(v, std::less<bool>(), threads);
+	}
+}
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef ARENA_ALLOCATOR_HPP
+# define ARENA_ALLOCATOR_HPP
+
+# include <new>
+# include <cstddef>
+# include "./utils/utils.hpp"
+
+namespace ft
+{
+/*
+* Bump allocator for containers that die together (one request, one
+* frame...). Memory comes from an optional caller buffer, then from
+* chunks of growing size, and is only given back by release() or the
+* destructor. Objects are not destroyed: containers still do that.
+*/
+	class arena
+	{
+	private:
+		struct chunk
+		{
+			chunk*		_next;
+			std::size_t	_size;
+		};
+
+		enum { max_chunk_size = 1 << 24 };
+
+		char*		_buffer;
+		std::size_t	_buffer_size;
+		std::size_t	_first_chunk_size;
+		std::size_t	_chunk_size;
+		chunk*		_chunks;
+		char*		_cur;
+		char*		_end;
+		std::size_t	_allocated;
+
+		arena(const arena&);
+		arena& operator=(const arena&);
+
+	public:
+		explicit arena(std::size_t chunk_size = 64 * 1024):
+			_buffer(t_nullptr),
+			_buffer_size(0),
+			_first_chunk_size(chunk_size),
+			_chunk_size(chunk_size),
+			_chunks(t_nullptr),
+			_cur(t_nullptr),
+			_end(t_nullptr),
+			_allocated(0)
+		{}
+
+		/* buffer is used first and never freed by the arena */
+		arena(void* buffer, std::size_t size, std::size_t chunk_size = 64 * 1024):
+			_buffer(static_cast<char*>(buffer)),
+			_buffer_size(size),
+			_first_chunk_size(chunk_size),
+			_chunk_size(chunk_size),
+			_chunks(t_nullptr),
+			_cur(_buffer),
+			_end(_buffer + size),
+			_allocated(0)
+		{}
+
+		~arena()
+		{
+			release();
+		}
+
+		void* allocate(std::size_t bytes, std::size_t align)
+		{
+			char* p = _align(_cur, align);
+			if (p > _end || std::size_t(_end - p) < bytes)
+				p = _grow(bytes, align);
+			_cur = p + bytes;
+			_allocated += bytes;
+			return p;
+		}
+
+		/* frees every chunk at once and rewinds to the caller buffer */
+		void release()
+		{
+			while (_chunks)
+			{
+				chunk* next = _chunks->_next;
+				::operator delete(_chunks);
+				_chunks = next;
+			}
+			_chunk_size = _first_chunk_size;
+			_cur = _buffer;
+			_end = _buffer + _buffer_size;
+			_allocated = 0;
+		}
+
+		/* bytes handed out since the last release() */
+		std::size_t allocated() const { return _allocated; }
+
+	private:
+		static char* _align(char* p, std::size_t align)
+		{
+			return reinterpret_cast<char*>((reinterpret_cast<std::size_t>(p) + align - 1) & ~(align - 1));
+		}
+
+		char* _grow(std::size_t bytes, std::size_t align)
+		{
+			std::size_t size = bytes + align > _chunk_size ? bytes + align : _chunk_size;
+			chunk* c = static_cast<chunk*>(::operator new(sizeof(chunk) + size));
+			c->_next = _chunks;
+			c->_size = size;
+			_chunks = c;
+			_cur = reinterpret_cast<char*>(c + 1);
+			_end = _cur + size;
+			if (_chunk_size < max_chunk_size)
+				_chunk_size *= 2;
+			return _align(_cur, align);
+		}
+	};
+
+	template <class T>
+	struct arena_alignment
+	{
+		struct probe
+		{
+			char	_c;
+			T		_t;
+		};
+
+		enum { value = sizeof(probe) - sizeof(T) };
+	};
+
+/*
+* Allocator view of an arena: deallocate() is a no-op and copies, rebinds
+* included, share the arena, so RBTree's node allocator uses it too.
+* A default-constructed arena_allocator has no arena and cannot allocate.
+*/
+	template <class T>
+	class arena_allocator
+	{
+	public:
+		typedef T				value_type;
+		typedef T*				pointer;
+		typedef const T*		const_pointer;
+		typedef T&				reference;
+		typedef const T&		const_reference;
+		typedef std::size_t		size_type;
+		typedef std::ptrdiff_t	difference_type;
+
+		template <class U>
+		struct rebind
+		{
+			typedef arena_allocator<U> other;
+		};
+
+	private:
+		arena*	_arena;
+
+	public:
+		arena_allocator(): _arena(t_nullptr) {}
+		arena_allocator(arena& a): _arena(&a) {}
+
+		template <class U>
+		arena_allocator(const arena_allocator<U>& x): _arena(x.get_arena()) {}
+
+		arena* get_arena() const { return _arena; }
+
+		pointer address(reference x) const { return &x; }
+		const_pointer address(const_reference x) const { return &x; }
+		size_type max_size() const { return size_type(-1) / sizeof(T); }
+
+		pointer allocate(size_type n, const void* = 0)
+		{
+			if (_arena == t_nullptr || n > max_size())
+				throw std::bad_alloc();
+			return static_cast<pointer>(_arena->allocate(n * sizeof(T), arena_alignment<T>::value));
+		}
+
+		void deallocate(pointer, size_type) {}
+
+		void construct(pointer p, const T& x) { new (p) T(x); }
+		void destroy(pointer p) { p->~T(); }
+	};
+
+	template <class T, class U>
+	bool operator==(const arena_allocator<T>& x, const arena_allocator<U>& y) { return x.get_arena() == y.get_arena(); }
+
+	template <class T, class U>
+	bool operator!=(const arena_allocator<T>& x, const arena_allocator<U>& y) { return x.get_arena() != y.get_arena(); }
+
+	template <class T>
+	struct is_monotonic_allocator<arena_allocator<T> > : public true_type {};
+}
+
+#endif
@@ -0,0 +1,1740 @@
+/*
+* Microbenchmarks, built twice by `make bench`: bench_ft against the ft::
+* containers and bench_std (-DBENCH_STD) against the std:: ones, same
+* code through the `lib` namespace alias.
+* Every container uses ft::stats_allocator, so allocs_per_op counts the
+* container's own allocations (not the ones inside std::string values).
+* ns_per_op is the best of several repetitions, rss_kb the resident set
+* right after the timed part. Output is CSV, or JSON with --json.
+* Built with -DFT_PERF_COUNTERS (make bench_perf) the ft containers are
+* instrumented and each case also prints the hardware counters of its
+* last repetition per container operation to stderr; ns_per_op then
+* includes the counter reads.
+*
+* usage: ./bench_ft [--json] [--sizes 1000,100000] [--threads 64]
+*/
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "../stats_allocator.hpp"
+
+#ifdef BENCH_STD
+	# include <deque>
+	# include <map>
+	# include <set>
+	# include <queue>
+	# include <stack>
+	namespace lib = std;
+	# define LIB_NAME "std"
+#else
+	# include "../vector.hpp"
+	# include "../deque.hpp"
+	# include "../map.hpp"
+	# include "../set.hpp"
+	# include "../stack.hpp"
+	# include "../priority_queue.hpp"
+	# include "../concurrent_stack.hpp"
+	# include "../ring_queue.hpp"
+	# include "../radix_map.hpp"
+	# include "../skiplist_map.hpp"
+	# include "../lru_cache.hpp"
+	# include "../stable_vector.hpp"
+	# include "../string.hpp"
+	# include "../algorithm.hpp"
+	# include "../serialize.hpp"
+	# include <fstream>
+	# include <list>
+	# ifdef __GLIBCXX__
+	#  include <tr1/unordered_map>
+	# endif
+	namespace lib = ft;
+	# define LIB_NAME "ft"
+#endif
+
+struct bench_tag {};
+typedef ft::alloc_stats<bench_tag>	stats;
+
+template <class T>
+struct bench_alloc
+{
+	typedef ft::stats_allocator<T, std::allocator<T>, bench_tag> type;
+};
+
+static volatile std::size_t g_sink;
+
+//section: measuring
+static double now_ns()
+{
+	struct timespec ts;
+	::clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* current resident set; peak resident set where /proc is missing */
+static long rss_kb()
+{
+	long pages, resident;
+	FILE* f = std::fopen("/proc/self/statm", "r");
+	if (f)
+	{
+		int got = std::fscanf(f, "%ld %ld", &pages, &resident);
+		std::fclose(f);
+		if (got == 2)
+			return resident * (::sysconf(_SC_PAGESIZE) / 1024);
+	}
+	struct rusage ru;
+	::getrusage(RUSAGE_SELF, &ru);
+#ifdef __APPLE__
+	return ru.ru_maxrss / 1024;
+#else
+	return ru.ru_maxrss;
+#endif
+}
+
+/* restarts the peak resident set (Linux clear_refs), false where it cannot */
+static bool reset_peak_rss()
+{
+	FILE* f = std::fopen("/proc/self/clear_refs", "w");
+	if (!f)
+		return false;
+	bool ok = std::fputs("5", f) >= 0;
+	return std::fclose(f) == 0 && ok;
+}
+
+/* peak resident set since reset_peak_rss() (VmHWM), the current one without /proc */
+static long peak_rss_kb()
+{
+	long kb = 0;
+	char line[128];
+	FILE* f = std::fopen("/proc/self/status", "r");
+	if (!f)
+		return rss_kb();
+	while (std::fgets(line, sizeof(line), f))
+		if (std::sscanf(line, "VmHWM: %ld kB", &kb) == 1)
+			break ;
+	std::fclose(f);
+	return kb ? kb : rss_kb();
+}
+
+class reporter
+{
+private:
+	bool	_json;
+	bool	_first;
+
+public:
+	explicit reporter(bool json): _json(json), _first(true)
+	{
+		if (_json)
+			std::cout << "[\n";
+		else
+			std::cout << "lib,container,value_type,op,size,threads,ns_per_op,allocs_per_op,rss_kb\n";
+	}
+
+	~reporter()
+	{
+		if (_json)
+			std::cout << "\n]\n";
+	}
+
+	void row(const char* container, const char* type, const char* op, std::size_t size,
+				unsigned threads, double ns, double allocs, long rss)
+	{
+		char buf[512];
+		if (_json)
+			snprintf(buf, sizeof(buf), "%s  {\"lib\": \"%s\", \"container\": \"%s\", \"value_type\": \"%s\", "
+					"\"op\": \"%s\", \"size\": %lu, \"threads\": %u, \"ns_per_op\": %.2f, "
+					"\"allocs_per_op\": %.4f, \"rss_kb\": %ld}",
+					_first ? "" : ",\n", LIB_NAME, container, type, op, (unsigned long)size, threads, ns, allocs, rss);
+		else
+			snprintf(buf, sizeof(buf), "%s,%s,%s,%s,%lu,%u,%.2f,%.4f,%ld\n",
+					LIB_NAME, container, type, op, (unsigned long)size, threads, ns, allocs, rss);
+		std::cout << buf << std::flush;
+		_first = false;
+	}
+};
+
+/*
+* Case: setup() and teardown() are not timed, run() is and returns how
+* many operations it did. Small sizes are repeated up to 20 times.
+* threads only fills the column, the case starts its own.
+*/
+template <class Case>
+void measure(reporter& out, const char* container, const char* type, const char* op,
+				std::size_t n, Case c, unsigned threads = 1)
+{
+	std::size_t reps = n >= 50000 ? 1 : 20;
+	double best = 0;
+	double allocs = 0;
+	long rss = 0;
+	for (std::size_t r = 0; r < reps; ++r)
+	{
+		c.setup();
+#ifdef FT_PERF_COUNTERS
+		ft::perf_registry::reset();
+#endif
+		ft::alloc_counters before = stats::snapshot();
+		double start = now_ns();
+		std::size_t ops = c.run();
+		double ns = (now_ns() - start) / (ops ? ops : 1);
+#ifdef FT_PERF_COUNTERS
+		if (r + 1 == reps)
+		{
+			std::cerr << "## " << container << ',' << type << ',' << op << ',' << n << '\n';
+			ft::perf_registry::report(std::cerr);
+		}
+#endif
+		ft::alloc_counters after = stats::snapshot();
+		if (r == 0 || ns < best)
+			best = ns;
+		allocs = double(after.allocations - before.allocations) / (ops ? ops : 1);
+		rss = rss_kb();
+		c.teardown();
+	}
+	out.row(container, type, op, n, threads, best, allocs, rss);
+}
+
+//section: values
+/* xorshift, same sequence in both builds */
+static std::size_t next_random(std::size_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	return state;
+}
+
+static std::vector<std::size_t> shuffled(std::size_t n, std::size_t seed)
+{
+	std::vector<std::size_t> v(n);
+	for (std::size_t i = 0; i < n; ++i)
+		v[i] = i;
+	for (std::size_t i = n; i > 1; --i)
+		std::swap(v[i - 1], v[next_random(seed) % i]);
+	return v;
+}
+
+template <class T> struct value_gen;
+
+template <> struct value_gen<int>
+{
+	static const char* name() { return "int"; }
+	static int make(std::size_t i) { return int(i); }
+};
+
+/* 20 characters: past the small-string buffer of common implementations */
+template <> struct value_gen<std::string>
+{
+	static const char* name() { return "string"; }
+	static std::string make(std::size_t i)
+	{
+		char buf[32];
+		snprintf(buf, sizeof(buf), "key-%016lu", (unsigned long)i);
+		return buf;
+	}
+};
+
+#ifndef BENCH_STD
+/* the same 20 characters, inline in ft::string */
+template <> struct value_gen<ft::string>
+{
+	static const char* name() { return "ft_string"; }
+	static ft::string make(std::size_t i) { return value_gen<std::string>::make(i).c_str(); }
+};
+#endif
+
+template <class T>
+std::vector<T> make_values(const std::vector<std::size_t>& order)
+{
+	std::vector<T> v;
+	v.reserve(order.size());
+	for (std::size_t i = 0; i < order.size(); ++i)
+		v.push_back(value_gen<T>::make(order[i]));
+	return v;
+}
+
+template <class T>
+std::size_t weight(const T& x) { return std::size_t(x); }
+
+inline std::size_t weight(const std::string& x) { return x.size(); }
+
+#ifndef BENCH_STD
+inline std::size_t weight(const ft::string& x) { return x.size(); }
+#endif
+
+//section: sequence containers (vector, deque)
+template <class C>
+struct seq_case
+{
+	typedef typename C::value_type	value_type;
+
+	const std::vector<value_type>*	_vals;
+	C*								_c;
+	C*								_copy;
+
+	explicit seq_case(const std::vector<value_type>& vals): _vals(&vals), _c(0), _copy(0) {}
+
+	void fill()
+	{
+		_c = new C();
+		for (std::size_t i = 0; i < _vals->size(); ++i)
+			_c->push_back((*_vals)[i]);
+	}
+
+	void setup() { fill(); }
+
+	void teardown()
+	{
+		delete _c;
+		delete _copy;
+		_c = 0;
+		_copy = 0;
+	}
+};
+
+template <class C>
+struct seq_push_back: public seq_case<C>
+{
+	explicit seq_push_back(const std::vector<typename C::value_type>& vals): seq_case<C>(vals) {}
+	void setup() { this->_c = new C(); }
+	std::size_t run()
+	{
+		for (std::size_t i = 0; i < this->_vals->size(); ++i)
+			this->_c->push_back((*this->_vals)[i]);
+		return this->_vals->size();
+	}
+};
+
+template <class C>
+struct seq_push_front: public seq_case<C>
+{
+	explicit seq_push_front(const std::vector<typename C::value_type>& vals): seq_case<C>(vals) {}
+	void setup() { this->_c = new C(); }
+	std::size_t run()
+	{
+		for (std::size_t i = 0; i < this->_vals->size(); ++i)
+			this->_c->push_front((*this->_vals)[i]);
+		return this->_vals->size();
+	}
+};
+
+template <class C>
+struct seq_reserve: public seq_case<C>
+{
+	explicit seq_reserve(const std::vector<typename C::value_type>& vals): seq_case<C>(vals) {}
+	void setup() { this->_c = new C(); }
+	std::size_t run()
+	{
+		this->_c->reserve(this->_vals->size());
+		for (std::size_t i = 0; i < this->_vals->size(); ++i)
+			this->_c->push_back((*this->_vals)[i]);
+		return this->_vals->size();
+	}
+};
+
+/* up to 1000 single inserts in the middle, each moves half the elements */
+template <class C>
+struct seq_insert: public seq_case<C>
+{
+	explicit seq_insert(const std::vector<typename C::value_type>& vals): seq_case<C>(vals) {}
+	std::size_t run()
+	{
+		std::size_t m = std::min<std::size_t>(this->_vals->size(), 1000);
+		for (std::size_t i = 0; i < m; ++i)
+			this->_c->insert(this->_c->begin() + this->_c->size() / 2, (*this->_vals)[i]);
+		return m;
+	}
+};
+
+template <class C>
+struct seq_erase: public seq_case<C>
+{
+	explicit seq_erase(const std::vector<typename C::value_type>& vals): seq_case<C>(vals) {}
+	std::size_t run()
+	{
+		std::size_t m = std::min<std::size_t>(this->_vals->size() / 2, 1000);
+		for (std::size_t i = 0; i < m; ++i)
+			this->_c->erase(this->_c->begin() + this->_c->size() / 2);
+		return m;
+	}
+};
+
+template <class C>
+struct seq_iterate: public seq_case<C>
+{
+	explicit seq_iterate(const std::vector<typename C::value_type>& vals): seq_case<C>(vals) {}
+	std::size_t run()
+	{
+		std::size_t sum = 0;
+		for (typename C::const_iterator it = this->_c->begin(); it != this->_c->end(); ++it)
+			sum += weight(*it);
+		g_sink = sum;
+		return this->_c->size();
+	}
+};
+
+template <class C>
+struct seq_copy: public seq_case<C>
+{
+	explicit seq_copy(const std::vector<typename C::value_type>& vals): seq_case<C>(vals) {}
+	std::size_t run()
+	{
+		this->_copy = new C(*this->_c);
+		return this->_c->size();
+	}
+};
+
+template <class C>
+struct seq_clear: public seq_case<C>
+{
+	explicit seq_clear(const std::vector<typename C::value_type>& vals): seq_case<C>(vals) {}
+	std::size_t run()
+	{
+		std::size_t n = this->_c->size();
+		this->_c->clear();
+		return n;
+	}
+};
+
+/* std::lower_bound over the sorted container, probes in random order */
+template <class C>
+struct seq_lower_bound: public seq_case<C>
+{
+	explicit seq_lower_bound(const std::vector<typename C::value_type>& vals): seq_case<C>(vals) {}
+	void setup()
+	{
+		this->fill();
+		std::sort(this->_c->begin(), this->_c->end());
+	}
+	std::size_t run()
+	{
+		std::size_t hits = 0;
+		for (std::size_t i = 0; i < this->_vals->size(); ++i)
+			hits += std::lower_bound(this->_c->begin(), this->_c->end(), (*this->_vals)[i]) != this->_c->end();
+		g_sink = hits;
+		return this->_vals->size();
+	}
+};
+
+template <class T>
+void bench_vector(reporter& out, std::size_t n)
+{
+	typedef lib::vector<T, typename bench_alloc<T>::type> C;
+	const char* type = value_gen<T>::name();
+	std::vector<T> vals = make_values<T>(shuffled(n, 1));
+
+	measure(out, "vector", type, "push_back", n, seq_push_back<C>(vals));
+	measure(out, "vector", type, "reserve", n, seq_reserve<C>(vals));
+	measure(out, "vector", type, "insert", n, seq_insert<C>(vals));
+	measure(out, "vector", type, "erase", n, seq_erase<C>(vals));
+	measure(out, "vector", type, "lower_bound", n, seq_lower_bound<C>(vals));
+	measure(out, "vector", type, "iterate", n, seq_iterate<C>(vals));
+	measure(out, "vector", type, "copy", n, seq_copy<C>(vals));
+	measure(out, "vector", type, "clear", n, seq_clear<C>(vals));
+}
+
+template <class T>
+void bench_deque(reporter& out, std::size_t n)
+{
+	typedef lib::deque<T, typename bench_alloc<T>::type> C;
+	const char* type = value_gen<T>::name();
+	std::vector<T> vals = make_values<T>(shuffled(n, 1));
+
+	measure(out, "deque", type, "push_back", n, seq_push_back<C>(vals));
+	measure(out, "deque", type, "push_front", n, seq_push_front<C>(vals));
+	measure(out, "deque", type, "insert", n, seq_insert<C>(vals));
+	measure(out, "deque", type, "erase", n, seq_erase<C>(vals));
+	measure(out, "deque", type, "iterate", n, seq_iterate<C>(vals));
+	measure(out, "deque", type, "copy", n, seq_copy<C>(vals));
+	measure(out, "deque", type, "clear", n, seq_clear<C>(vals));
+}
+
+/*
+* main.cpp's Buffer through a stack: 4100-byte elements pushed, then
+* popped. rss_kb is the peak resident set over the pushes, where vector
+* holds its old and new storage at once while it reallocates. At most
+* 100000 elements (400 MB).
+*/
+struct Buffer
+{
+	int		idx;
+	char	buff[4096];
+};
+
+template <class Stack>
+void bench_buffer_stack(reporter& out, const char* container, std::size_t n)
+{
+	n = std::min<std::size_t>(n, 100000);
+	Stack* s = new Stack();
+	bool peak = reset_peak_rss();
+	ft::alloc_counters before = stats::snapshot();
+	double start = now_ns();
+	for (std::size_t i = 0; i < n; ++i)
+		s->push(Buffer());
+	double ns = now_ns() - start;
+	ft::alloc_counters after = stats::snapshot();
+	out.row(container, "Buffer", "push", n, 1, ns / n,
+			double(after.allocations - before.allocations) / n, peak ? peak_rss_kb() : rss_kb());
+	before = after;
+	start = now_ns();
+	std::size_t sum = 0;
+	while (!s->empty())
+	{
+		sum += s->top().idx;
+		s->pop();
+	}
+	ns = now_ns() - start;
+	after = stats::snapshot();
+	g_sink = sum;
+	out.row(container, "Buffer", "pop", n, 1, ns / n,
+			double(after.allocations - before.allocations) / n, rss_kb());
+	delete s;
+}
+
+static void bench_buffer(reporter& out, std::size_t n)
+{
+	typedef bench_alloc<Buffer>::type	alloc;
+	bench_buffer_stack<lib::stack<Buffer, lib::deque<Buffer, alloc> > >(out, "stack_deque", n);
+	bench_buffer_stack<lib::stack<Buffer, lib::vector<Buffer, alloc> > >(out, "stack_vector", n);
+}
+
+/* ft only: no middle insert/erase, the rows to compare are vector's and deque's */
+#ifndef BENCH_STD
+template <class T>
+void bench_stable_vector(reporter& out, std::size_t n)
+{
+	typedef ft::stable_vector<T, typename bench_alloc<T>::type> C;
+	const char* type = value_gen<T>::name();
+	std::vector<T> vals = make_values<T>(shuffled(n, 1));
+
+	measure(out, "stable_vector", type, "push_back", n, seq_push_back<C>(vals));
+	measure(out, "stable_vector", type, "reserve", n, seq_reserve<C>(vals));
+	measure(out, "stable_vector", type, "lower_bound", n, seq_lower_bound<C>(vals));
+	measure(out, "stable_vector", type, "iterate", n, seq_iterate<C>(vals));
+	measure(out, "stable_vector", type, "copy", n, seq_copy<C>(vals));
+	measure(out, "stable_vector", type, "clear", n, seq_clear<C>(vals));
+}
+#endif
+
+/* ft only: vector<char> filled 4 KiB at a time as by read(), ns per byte */
+#ifndef BENCH_STD
+enum io_fill { io_resize, io_default_init, io_append };
+
+template <class C>
+struct io_buffer_fill
+{
+	const std::vector<char>*	_src;
+	io_fill						_how;
+	C*							_c;
+
+	io_buffer_fill(const std::vector<char>& src, io_fill how): _src(&src), _how(how), _c(0) {}
+
+	void setup() { _c = new C(); }
+
+	std::size_t run()
+	{
+		const std::size_t block = 4096;
+		const std::size_t n = _src->size();
+		for (std::size_t done = 0; done < n; done += block)
+		{
+			std::size_t len = std::min(block, n - done);
+			std::size_t old = _c->size();
+			if (_how == io_append)
+				_c->append(&(*_src)[done], len);
+			else
+			{
+				if (_how == io_resize)
+					_c->resize(old + len);
+				else
+					_c->resize_default_init(old + len);
+				std::memcpy(_c->data() + old, &(*_src)[done], len);
+			}
+		}
+		g_sink = _c->size();
+		return n;
+	}
+
+	void teardown()
+	{
+		delete _c;
+		_c = 0;
+	}
+};
+
+static void bench_io_buffer(reporter& out, std::size_t n)
+{
+	typedef ft::vector<char, bench_alloc<char>::type> C;
+	std::vector<char> src(n, 'x');
+	measure(out, "vector", "char", "read_resize", n, io_buffer_fill<C>(src, io_resize));
+	measure(out, "vector", "char", "read_default_init", n, io_buffer_fill<C>(src, io_default_init));
+	measure(out, "vector", "char", "read_append", n, io_buffer_fill<C>(src, io_append));
+}
+#endif
+
+//section: associative containers (map, set)
+template <class K, class Compare, class Alloc>
+void add(lib::set<K, Compare, Alloc>& s, const K& k) { s.insert(k); }
+
+template <class K, class V, class Compare, class Alloc>
+void add(lib::map<K, V, Compare, Alloc>& m, const K& k) { m.insert(typename lib::map<K, V, Compare, Alloc>::value_type(k, V())); }
+
+/* _keys fill the container, _probes are the same keys in another order */
+template <class C>
+struct assoc_case
+{
+	typedef typename C::key_type	key_type;
+
+	const std::vector<key_type>*	_keys;
+	const std::vector<key_type>*	_probes;
+	C*								_c;
+	C*								_copy;
+
+	assoc_case(const std::vector<key_type>& keys, const std::vector<key_type>& probes):
+		_keys(&keys), _probes(&probes), _c(0), _copy(0) {}
+
+	void fill()
+	{
+		_c = new C();
+		for (std::size_t i = 0; i < _keys->size(); ++i)
+			add(*_c, (*_keys)[i]);
+	}
+
+	void setup() { fill(); }
+
+	void teardown()
+	{
+		delete _c;
+		delete _copy;
+		_c = 0;
+		_copy = 0;
+	}
+};
+
+# define ASSOC_CASE(name) \
+	typedef typename C::key_type key_type; \
+	name(const std::vector<key_type>& keys, const std::vector<key_type>& probes): assoc_case<C>(keys, probes) {}
+
+template <class C>
+struct assoc_insert: public assoc_case<C>
+{
+	ASSOC_CASE(assoc_insert)
+	void setup() { this->_c = new C(); }
+	std::size_t run()
+	{
+		for (std::size_t i = 0; i < this->_keys->size(); ++i)
+			add(*this->_c, (*this->_keys)[i]);
+		return this->_keys->size();
+	}
+};
+
+template <class C>
+struct assoc_find: public assoc_case<C>
+{
+	ASSOC_CASE(assoc_find)
+	std::size_t run()
+	{
+		std::size_t hits = 0;
+		for (std::size_t i = 0; i < this->_probes->size(); ++i)
+			hits += this->_c->find((*this->_probes)[i]) != this->_c->end();
+		g_sink = hits;
+		return this->_probes->size();
+	}
+};
+
+template <class C>
+struct assoc_lower_bound: public assoc_case<C>
+{
+	ASSOC_CASE(assoc_lower_bound)
+	std::size_t run()
+	{
+		std::size_t hits = 0;
+		for (std::size_t i = 0; i < this->_probes->size(); ++i)
+			hits += this->_c->lower_bound((*this->_probes)[i]) != this->_c->end();
+		g_sink = hits;
+		return this->_probes->size();
+	}
+};
+
+template <class C>
+struct assoc_erase: public assoc_case<C>
+{
+	ASSOC_CASE(assoc_erase)
+	std::size_t run()
+	{
+		for (std::size_t i = 0; i < this->_probes->size(); ++i)
+			this->_c->erase((*this->_probes)[i]);
+		return this->_probes->size();
+	}
+};
+
+template <class C>
+struct assoc_iterate: public assoc_case<C>
+{
+	ASSOC_CASE(assoc_iterate)
+	std::size_t run()
+	{
+		std::size_t count = 0;
+		for (typename C::const_iterator it = this->_c->begin(); it != this->_c->end(); ++it)
+			++count;
+		g_sink = count;
+		return count;
+	}
+};
+
+template <class C>
+struct assoc_copy: public assoc_case<C>
+{
+	ASSOC_CASE(assoc_copy)
+	std::size_t run()
+	{
+		this->_copy = new C(*this->_c);
+		return this->_c->size();
+	}
+};
+
+template <class C>
+struct assoc_clear: public assoc_case<C>
+{
+	ASSOC_CASE(assoc_clear)
+	std::size_t run()
+	{
+		std::size_t n = this->_c->size();
+		this->_c->clear();
+		return n;
+	}
+};
+
+# undef ASSOC_CASE
+
+template <class C>
+void bench_assoc(reporter& out, const char* container, const char* type, std::size_t n)
+{
+	typedef typename C::key_type K;
+	std::vector<K> keys = make_values<K>(shuffled(n, 1));
+	std::vector<K> probes = make_values<K>(shuffled(n, 2));
+
+	measure(out, container, type, "insert", n, assoc_insert<C>(keys, probes));
+	measure(out, container, type, "find", n, assoc_find<C>(keys, probes));
+	measure(out, container, type, "lower_bound", n, assoc_lower_bound<C>(keys, probes));
+	measure(out, container, type, "erase", n, assoc_erase<C>(keys, probes));
+	measure(out, container, type, "iterate", n, assoc_iterate<C>(keys, probes));
+	measure(out, container, type, "copy", n, assoc_copy<C>(keys, probes));
+	measure(out, container, type, "clear", n, assoc_clear<C>(keys, probes));
+}
+
+template <class T>
+void bench_map(reporter& out, std::size_t n)
+{
+	typedef typename lib::map<T, int>::value_type value_type;
+	typedef lib::map<T, int, std::less<T>, typename bench_alloc<value_type>::type> C;
+	bench_assoc<C>(out, "map", value_gen<T>::name(), n);
+}
+
+template <class T>
+void bench_set(reporter& out, std::size_t n)
+{
+	typedef lib::set<T, std::less<T>, typename bench_alloc<T>::type> C;
+	bench_assoc<C>(out, "set", value_gen<T>::name(), n);
+}
+
+//section: priority_queue
+template <class C>
+struct pq_push
+{
+	typedef typename C::value_type	value_type;
+
+	const std::vector<value_type>*	_vals;
+	C*								_c;
+
+	explicit pq_push(const std::vector<value_type>& vals): _vals(&vals), _c(0) {}
+	void setup() { _c = new C(); }
+	std::size_t run()
+	{
+		for (std::size_t i = 0; i < _vals->size(); ++i)
+			_c->push((*_vals)[i]);
+		return _vals->size();
+	}
+	void teardown() { delete _c; _c = 0; }
+};
+
+template <class C>
+struct pq_pop: public pq_push<C>
+{
+	explicit pq_pop(const std::vector<typename C::value_type>& vals): pq_push<C>(vals) {}
+	void setup()
+	{
+		pq_push<C>::setup();
+		pq_push<C>::run();
+	}
+	std::size_t run()
+	{
+		std::size_t n = this->_c->size();
+		while (!this->_c->empty())
+			this->_c->pop();
+		return n;
+	}
+};
+
+template <class T>
+void bench_priority_queue(reporter& out, std::size_t n)
+{
+	typedef lib::priority_queue<T, lib::vector<T, typename bench_alloc<T>::type> > C;
+	std::vector<T> vals = make_values<T>(shuffled(n, 1));
+
+	measure(out, "priority_queue", value_gen<T>::name(), "push", n, pq_push<C>(vals));
+	measure(out, "priority_queue", value_gen<T>::name(), "pop", n, pq_pop<C>(vals));
+}
+
+/*
+* Hold model, the scheduler pattern: n events queued, then n rounds that
+* take the earliest and schedule one later. The same keys go through the
+* priority_queue (min first) and through a map<time, task> used as a
+* queue, insert and erase(begin()). A key is time * _serials + serial, so
+* no two are equal.
+*/
+struct schedule_keys
+{
+	std::vector<long long>	_first;
+	std::vector<long long>	_delta;
+	long long				_serials;
+};
+
+static schedule_keys make_schedule(std::size_t n)
+{
+	schedule_keys keys;
+	std::size_t state = 7;
+	keys._serials = static_cast<long long>(2 * n + 1);
+	for (std::size_t i = 0; i < n; ++i)
+		keys._first.push_back(static_cast<long long>(next_random(state) % (n + 1)) * keys._serials + i);
+	for (std::size_t i = 0; i < n; ++i)
+		keys._delta.push_back(static_cast<long long>(next_random(state) % (n + 1)) + 1);
+	return keys;
+}
+
+/* the event scheduled by round i, once `key` was taken */
+static long long schedule_next(const schedule_keys& keys, long long key, std::size_t i)
+{
+	return (key / keys._serials + keys._delta[i]) * keys._serials
+		+ static_cast<long long>(keys._first.size() + i);
+}
+
+template <class C>
+struct pq_schedule
+{
+	const schedule_keys*	_keys;
+	C*						_c;
+
+	explicit pq_schedule(const schedule_keys& keys): _keys(&keys), _c(0) {}
+	void setup()
+	{
+		_c = new C();
+		for (std::size_t i = 0; i < _keys->_first.size(); ++i)
+			_c->push(_keys->_first[i]);
+	}
+	std::size_t run()
+	{
+		for (std::size_t i = 0; i < _keys->_delta.size(); ++i)
+		{
+			long long key = _c->top();
+			_c->pop();
+			_c->push(schedule_next(*_keys, key, i));
+		}
+		return _keys->_delta.size();
+	}
+	void teardown() { delete _c; _c = 0; }
+};
+
+template <class M>
+struct map_schedule
+{
+	const schedule_keys*	_keys;
+	M*						_m;
+
+	explicit map_schedule(const schedule_keys& keys): _keys(&keys), _m(0) {}
+	void setup()
+	{
+		_m = new M();
+		for (std::size_t i = 0; i < _keys->_first.size(); ++i)
+			_m->insert(lib::make_pair(_keys->_first[i], int(i)));
+	}
+	std::size_t run()
+	{
+		std::size_t tasks = 0;
+		for (std::size_t i = 0; i < _keys->_delta.size(); ++i)
+		{
+			long long key = _m->begin()->first;
+			tasks += _m->begin()->second;
+			_m->erase(_m->begin());
+			_m->insert(lib::make_pair(schedule_next(*_keys, key, i), int(i)));
+		}
+		g_sink = tasks;
+		return _keys->_delta.size();
+	}
+	void teardown() { delete _m; _m = 0; }
+};
+
+static void bench_schedule(reporter& out, std::size_t n)
+{
+	typedef lib::vector<long long, bench_alloc<long long>::type>			heap;
+	typedef lib::priority_queue<long long, heap, std::greater<long long> >	queue;
+	typedef bench_alloc<lib::pair<const long long, int> >::type			node_alloc;
+	typedef lib::map<long long, int, std::less<long long>, node_alloc>		queue_map;
+	schedule_keys keys = make_schedule(n);
+
+	measure(out, "priority_queue", "long_long", "schedule", n, pq_schedule<queue>(keys));
+	measure(out, "map_as_queue", "long_long", "schedule", n, map_schedule<queue_map>(keys));
+}
+
+//section: radix_map (ft only, against ft::map and a hash table)
+#ifndef BENCH_STD
+typedef unsigned long long	u64;
+
+template <class K, class V, class Traits, class Alloc>
+void add(ft::radix_map<K, V, Traits, Alloc>& m, const K& k) { m.insert(typename ft::radix_map<K, V, Traits, Alloc>::value_type(k, V())); }
+
+# ifdef __GLIBCXX__
+template <class K, class V, class Hash, class Eq, class Alloc>
+void add(std::tr1::unordered_map<K, V, Hash, Eq, Alloc>& m, const K& k) { m.insert(std::make_pair(k, V())); }
+# endif
+
+/* dense: 0 .. n - 1; sparse: the same indexes spread over 64 bits (splitmix64 finalizer, a bijection) */
+static std::vector<u64> make_u64(const std::vector<std::size_t>& order, bool sparse)
+{
+	std::vector<u64> v(order.size());
+	for (std::size_t i = 0; i < order.size(); ++i)
+	{
+		u64 x = order[i];
+		if (sparse)
+		{
+			x += 0x9e3779b97f4a7c15ULL;
+			x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+			x ^= x >> 31;
+		}
+		v[i] = x;
+	}
+	return v;
+}
+
+/* the cases every keyed container has */
+template <class C>
+void bench_keyed(reporter& out, const char* container, const char* type,
+		const std::vector<typename C::key_type>& keys, const std::vector<typename C::key_type>& probes)
+{
+	std::size_t n = keys.size();
+	measure(out, container, type, "insert", n, assoc_insert<C>(keys, probes));
+	measure(out, container, type, "find", n, assoc_find<C>(keys, probes));
+	measure(out, container, type, "erase", n, assoc_erase<C>(keys, probes));
+	measure(out, container, type, "iterate", n, assoc_iterate<C>(keys, probes));
+	measure(out, container, type, "copy", n, assoc_copy<C>(keys, probes));
+	measure(out, container, type, "clear", n, assoc_clear<C>(keys, probes));
+}
+
+template <class C>
+void bench_ordered(reporter& out, const char* container, const char* type,
+		const std::vector<typename C::key_type>& keys, const std::vector<typename C::key_type>& probes)
+{
+	bench_keyed<C>(out, container, type, keys, probes);
+	measure(out, container, type, "lower_bound", keys.size(), assoc_lower_bound<C>(keys, probes));
+}
+
+static void bench_radix(reporter& out, std::size_t n)
+{
+	typedef ft::pair<const u64, int>									u64_value;
+	typedef ft::radix_map<u64, int, ft::radix_key<u64>, bench_alloc<u64_value>::type>	radix_u64;
+	typedef ft::map<u64, int, std::less<u64>, bench_alloc<u64_value>::type>			map_u64;
+	for (int sparse = 0; sparse < 2; ++sparse)
+	{
+		const char* type = sparse ? "u64_sparse" : "u64_dense";
+		std::vector<u64> keys = make_u64(shuffled(n, 1), sparse);
+		std::vector<u64> probes = make_u64(shuffled(n, 2), sparse);
+		bench_ordered<radix_u64>(out, "radix_map", type, keys, probes);
+		bench_ordered<map_u64>(out, "map", type, keys, probes);
+# ifdef __GLIBCXX__
+		typedef std::pair<const u64, int>	hash_value;
+		typedef std::tr1::unordered_map<u64, int, std::tr1::hash<u64>, std::equal_to<u64>,
+				bench_alloc<hash_value>::type>	hash_u64;
+		bench_keyed<hash_u64>(out, "tr1_unordered_map", type, keys, probes);
+# endif
+	}
+	typedef ft::pair<const std::string, int>	str_value;
+	typedef ft::radix_map<std::string, int, ft::radix_key<std::string>, bench_alloc<str_value>::type>	radix_str;
+	std::vector<std::string> keys = make_values<std::string>(shuffled(n, 1));
+	std::vector<std::string> probes = make_values<std::string>(shuffled(n, 2));
+	bench_ordered<radix_str>(out, "radix_map", "string", keys, probes);
+}
+#endif
+
+//section: lru_cache (ft only, against a map plus a separate recency list)
+#ifndef BENCH_STD
+/* the hand-made cache lru_cache replaces: two allocations per entry, two structures per hit */
+template <class K, class V>
+class map_list_cache
+{
+private:
+	typedef std::list<K, typename bench_alloc<K>::type>						list_type;
+	typedef ft::pair<V, typename list_type::iterator>						entry;
+	typedef ft::pair<const K, entry>										value_type;
+	typedef ft::map<K, entry, std::less<K>, typename bench_alloc<value_type>::type>	map_type;
+
+	std::size_t	_capacity;
+	map_type	_map;
+	list_type	_recency;	/* front is the most recently used */
+
+public:
+	explicit map_list_cache(std::size_t capacity): _capacity(capacity) {}
+
+	V* get(const K& k)
+	{
+		typename map_type::iterator it = _map.find(k);
+		if (it == _map.end())
+			return 0;
+		_recency.splice(_recency.begin(), _recency, it->second.second);
+		return &it->second.first;
+	}
+
+	void put(const K& k, const V& v)
+	{
+		if (_map.size() == _capacity)
+		{
+			_map.erase(_recency.back());
+			_recency.pop_back();
+		}
+		_recency.push_front(k);
+		_map.insert(value_type(k, entry(v, _recency.begin())));
+	}
+};
+
+/* get, and put on a miss: keys cycle over twice the capacity, so about half the gets hit */
+template <class Cache>
+struct lru_get_or_put
+{
+	const std::vector<u64>*	_probes;
+	std::size_t				_capacity;
+	Cache*					_c;
+
+	lru_get_or_put(const std::vector<u64>& probes, std::size_t capacity):
+		_probes(&probes), _capacity(capacity), _c(0) {}
+
+	void setup() { _c = new Cache(_capacity); }
+
+	std::size_t run()
+	{
+		std::size_t sum = 0;
+		for (std::size_t i = 0; i < _probes->size(); ++i)
+		{
+			u64 k = (*_probes)[i];
+			int* v = _c->get(k);
+			if (v)
+				sum += *v;
+			else
+				_c->put(k, int(i));
+		}
+		g_sink = sum;
+		return _probes->size();
+	}
+
+	void teardown()
+	{
+		delete _c;
+		_c = 0;
+	}
+};
+
+static void bench_lru(reporter& out, std::size_t n)
+{
+	typedef ft::pair<const u64, int>	value;
+	typedef ft::lru_cache<u64, int, ft::lru_hash_index<u64>, bench_alloc<value>::type>	lru_hash;
+	typedef ft::lru_cache<u64, int, ft::lru_tree_index<u64>, bench_alloc<value>::type>	lru_tree;
+	std::size_t capacity = n / 2 ? n / 2 : 1;
+	std::vector<u64> keys = make_u64(shuffled(n, 1), true);
+	std::vector<u64> probes(2 * n);
+	std::size_t state = 3;
+	for (std::size_t i = 0; i < probes.size(); ++i)
+		probes[i] = keys[next_random(state) % n];
+	measure(out, "lru_cache_hash", "u64_sparse", "get_or_put", n, lru_get_or_put<lru_hash>(probes, capacity));
+	measure(out, "lru_cache_tree", "u64_sparse", "get_or_put", n, lru_get_or_put<lru_tree>(probes, capacity));
+	measure(out, "map_list_cache", "u64_sparse", "get_or_put", n, lru_get_or_put<map_list_cache<u64, int> >(probes, capacity));
+}
+#endif
+
+//section: startup from a file (ft only): per-record insert vs load_binary vs mapped_vector
+#ifndef BENCH_STD
+typedef ft::vector<int, bench_alloc<int>::type>											int_vector;
+typedef ft::map<int, int, std::less<int>, bench_alloc<ft::pair<const int, int> >::type>	int_map;
+
+enum startup_how { startup_insert, startup_load, startup_mapped };
+
+/* map file written by write_binary: records read one at a time and inserted */
+static void insert_records(const char* path, int_map& m)
+{
+	std::FILE* f = std::fopen(path, "rb");
+	if (!f)
+		return ;
+	const std::size_t second = ft::binary_map_second<int, int>();
+	char record[sizeof(ft::pair<int, int>)];
+	std::fseek(f, sizeof(ft::binary_header), SEEK_SET);
+	while (std::fread(record, sizeof(record), 1, f) == 1)
+	{
+		int k, v;
+		std::memcpy(&k, record, sizeof(k));
+		std::memcpy(&v, record + second, sizeof(v));
+		m.insert(ft::make_pair(k, v));
+	}
+	std::fclose(f);
+}
+
+struct startup_map
+{
+	const char*	_path;
+	startup_how	_how;
+	int_map*	_m;
+
+	startup_map(const char* path, startup_how how): _path(path), _how(how), _m(0) {}
+	void setup() { _m = new int_map(); }
+	std::size_t run()
+	{
+		if (_how == startup_insert)
+			insert_records(_path, *_m);
+		else
+			ft::load_binary(_path, *_m);
+		return _m->size();
+	}
+	void teardown() { delete _m; _m = 0; }
+};
+
+struct startup_vector
+{
+	const char*						_path;
+	startup_how						_how;
+	int_vector*						_v;
+	ft::mapped_vector<int>*			_mapped;
+
+	startup_vector(const char* path, startup_how how): _path(path), _how(how), _v(0), _mapped(0) {}
+	void setup() { _v = new int_vector(); }
+	std::size_t run()
+	{
+		if (_how == startup_mapped)
+		{
+			_mapped = new ft::mapped_vector<int>(_path);
+			return _mapped->size();
+		}
+		ft::load_binary(_path, *_v);
+		return _v->size();
+	}
+	void teardown()
+	{
+		delete _v;
+		delete _mapped;
+		_v = 0;
+		_mapped = 0;
+	}
+};
+
+/* ns per record to get an n-entry map<int, int> / vector<int> back from a warm file */
+static void bench_startup(reporter& out, std::size_t n)
+{
+	char map_path[256];
+	char vector_path[256];
+	snprintf(map_path, sizeof(map_path), "%s/ft_bench_%ld_map.bin", P_tmpdir, long(::getpid()));
+	snprintf(vector_path, sizeof(vector_path), "%s/ft_bench_%ld_vector.bin", P_tmpdir, long(::getpid()));
+	{
+		int_map m;
+		int_vector v;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			m.insert(m.end(), ft::make_pair(int(i), int(i)));
+			v.push_back(int(i));
+		}
+		std::ofstream map_file(map_path, std::ios::binary);
+		ft::write_binary(map_file, m);
+		std::ofstream vector_file(vector_path, std::ios::binary);
+		ft::write_binary(vector_file, v);
+	}
+	measure(out, "map", "int", "startup_insert", n, startup_map(map_path, startup_insert));
+	measure(out, "map", "int", "startup_load_binary", n, startup_map(map_path, startup_load));
+	measure(out, "vector", "int", "startup_load_binary", n, startup_vector(vector_path, startup_load));
+	measure(out, "vector", "int", "startup_mapped_vector", n, startup_vector(vector_path, startup_mapped));
+	std::remove(map_path);
+	std::remove(vector_path);
+}
+#endif
+
+//section: parallel_sort and assign_sorted (ft only, 1 .. --threads threads, std::sort as baseline)
+#ifndef BENCH_STD
+struct sort_std { static void run(int_vector& v, unsigned) { std::sort(v.begin(), v.end()); } };
+struct sort_radix { static void run(int_vector& v, unsigned threads) { ft::parallel_sort(v, threads); } };
+struct sort_merge { static void run(int_vector& v, unsigned threads) { ft::parallel_sort(v, std::less<int>(), threads); } };
+
+/* the shuffled values are copied in untimed, then sorted */
+template <class Sort>
+struct sort_case
+{
+	const std::vector<int>*	_vals;
+	unsigned				_threads;
+	int_vector*				_v;
+
+	sort_case(const std::vector<int>& vals, unsigned threads): _vals(&vals), _threads(threads), _v(0) {}
+	void setup() { _v = new int_vector(_vals->begin(), _vals->end()); }
+	std::size_t run()
+	{
+		Sort::run(*_v, _threads);
+		return _v->size();
+	}
+	void teardown() { delete _v; _v = 0; }
+};
+
+/* map<int, int> bulk-built from sorted pairs */
+struct assign_sorted_case
+{
+	const std::vector<ft::pair<int, int> >*	_pairs;
+	unsigned								_threads;
+	int_map*								_m;
+
+	assign_sorted_case(const std::vector<ft::pair<int, int> >& pairs, unsigned threads):
+		_pairs(&pairs), _threads(threads), _m(0) {}
+	void setup() { _m = new int_map(); }
+	std::size_t run()
+	{
+		_m->assign_sorted(_pairs->begin(), _pairs->end(), _threads);
+		return _m->size();
+	}
+	void teardown() { delete _m; _m = 0; }
+};
+
+/* merge sort splits from 8192 elements on, the tree build from 65536 */
+static void bench_parallel(reporter& out, std::size_t n, unsigned max_threads)
+{
+	std::vector<int> vals = make_values<int>(shuffled(n, 1));
+	std::vector<ft::pair<int, int> > pairs(n);
+	for (std::size_t i = 0; i < n; ++i)
+		pairs[i] = ft::make_pair(int(i), int(i));
+	measure(out, "vector", "int", "std_sort", n, sort_case<sort_std>(vals, 1));
+	for (unsigned t = 1; t <= max_threads; t *= 2)
+	{
+		measure(out, "vector", "int", "parallel_sort_radix", n, sort_case<sort_radix>(vals, t), t);
+		measure(out, "vector", "int", "parallel_sort_merge", n, sort_case<sort_merge>(vals, t), t);
+		measure(out, "map", "int", "assign_sorted", n, assign_sorted_case(pairs, t), t);
+	}
+}
+#endif
+
+//section: find loop vs find_many on a map larger than the last-level cache (ft only)
+#ifndef BENCH_STD
+/* output iterator for find_many that only counts the iterators that are not end */
+struct hit_counter
+{
+	int_map::iterator	_end;
+	std::size_t*		_hits;
+
+	hit_counter& operator*() { return *this; }
+	hit_counter& operator=(const int_map::iterator& it)
+	{
+		*_hits += it != _end;
+		return *this;
+	}
+	hit_counter& operator++() { return *this; }
+	hit_counter operator++(int) { return *this; }
+};
+
+struct cold_find
+{
+	const int_map*				_m;
+	const std::vector<int>*		_probes;
+
+	cold_find(const int_map& m, const std::vector<int>& probes): _m(&m), _probes(&probes) {}
+	void setup() {}
+	std::size_t run()
+	{
+		std::size_t hits = 0;
+		for (std::size_t i = 0; i < _probes->size(); ++i)
+			hits += _m->find((*_probes)[i]) != _m->end();
+		g_sink = hits;
+		return _probes->size();
+	}
+	void teardown() {}
+};
+
+struct cold_find_many
+{
+	int_map*					_m;
+	const std::vector<int>*		_probes;
+
+	cold_find_many(int_map& m, const std::vector<int>& probes): _m(&m), _probes(&probes) {}
+	void setup() {}
+	std::size_t run()
+	{
+		std::size_t hits = 0;
+		hit_counter counter = { _m->end(), &hits };
+		_m->find_many(_probes->begin(), _probes->end(), counter);
+		g_sink = hits;
+		return _probes->size();
+	}
+	void teardown() {}
+};
+
+/* last-level cache in bytes, 32 MB where sysconf does not say */
+static std::size_t llc_bytes()
+{
+	long bytes = 0;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+	bytes = ::sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+	return bytes > 0 ? static_cast<std::size_t>(bytes) : std::size_t(32) << 20;
+}
+
+/*
+* Nodes take four times the last-level cache, 1M to 8M keys, inserted
+* in shuffled order so neighbours in the tree are not neighbours in memory.
+* 1M random probes, half of them hits; run once, whatever --sizes says.
+*/
+static void bench_find_cold(reporter& out)
+{
+	std::size_t n = 4 * llc_bytes() / (sizeof(int_map::value_type) + 4 * sizeof(void*));
+	n = std::max(n, std::size_t(1) << 20);
+	n = std::min(n, std::size_t(1) << 23);
+	int_map m;
+	std::vector<std::size_t> order = shuffled(n, 3);
+	for (std::size_t i = 0; i < n; ++i)
+		m.insert(ft::make_pair(int(2 * order[i]), int(i)));
+	std::vector<int> probes;
+	std::size_t state = 11;
+	for (std::size_t i = 0; i < (std::size_t(1) << 20); ++i)
+		probes.push_back(int(next_random(state) % (2 * n)));
+	measure(out, "map", "int", "find_cold", n, cold_find(m, probes));
+	measure(out, "map", "int", "find_many_cold", n, cold_find_many(m, probes));
+}
+#endif
+
+//section: concurrent containers (ft only, against mutex-wrapped baselines)
+#ifndef BENCH_STD
+/* threads wait here until all of them are running */
+struct start_gate
+{
+	unsigned	_waiting;
+
+	void arrive_and_wait(unsigned total)
+	{
+		__atomic_add_fetch(&_waiting, 1, __ATOMIC_ACQ_REL);
+		while (__atomic_load_n(&_waiting, __ATOMIC_ACQUIRE) < total)
+			::sched_yield();
+	}
+};
+
+template <class Worker>
+double run_threads(Worker& w, unsigned threads)
+{
+	std::vector<pthread_t> ids(threads);
+	w._gate._waiting = 0;
+	for (unsigned i = 0; i < threads; ++i)
+		::pthread_create(&ids[i], 0, &Worker::entry, &w);
+	w._gate.arrive_and_wait(threads + 1);
+	double start = now_ns();
+	for (unsigned i = 0; i < threads; ++i)
+		::pthread_join(ids[i], 0);
+	return now_ns() - start;
+}
+
+template <class T>
+class mutex_stack
+{
+private:
+	pthread_mutex_t								_lock;
+	ft::stack<T, ft::vector<T, typename bench_alloc<T>::type> >	_stack;
+
+public:
+	mutex_stack() { ::pthread_mutex_init(&_lock, 0); }
+	~mutex_stack() { ::pthread_mutex_destroy(&_lock); }
+
+	void push(const T& x)
+	{
+		::pthread_mutex_lock(&_lock);
+		_stack.push(x);
+		::pthread_mutex_unlock(&_lock);
+	}
+
+	bool pop(T& x)
+	{
+		::pthread_mutex_lock(&_lock);
+		bool ok = !_stack.empty();
+		if (ok)
+		{
+			x = _stack.top();
+			_stack.pop();
+		}
+		::pthread_mutex_unlock(&_lock);
+		return ok;
+	}
+};
+
+/* bounded, same push/pop contract as ring_queue */
+template <class T>
+class mutex_queue
+{
+private:
+	pthread_mutex_t										_lock;
+	ft::deque<T, typename bench_alloc<T>::type>			_queue;
+	std::size_t											_capacity;
+
+public:
+	explicit mutex_queue(std::size_t capacity): _capacity(capacity) { ::pthread_mutex_init(&_lock, 0); }
+	~mutex_queue() { ::pthread_mutex_destroy(&_lock); }
+
+	bool push(const T& x)
+	{
+		::pthread_mutex_lock(&_lock);
+		bool ok = _queue.size() < _capacity;
+		if (ok)
+			_queue.push_back(x);
+		::pthread_mutex_unlock(&_lock);
+		return ok;
+	}
+
+	bool pop(T& x)
+	{
+		::pthread_mutex_lock(&_lock);
+		bool ok = !_queue.empty();
+		if (ok)
+		{
+			x = _queue.front();
+			_queue.pop_front();
+		}
+		::pthread_mutex_unlock(&_lock);
+		return ok;
+	}
+};
+
+/* ft::map behind one mutex, with the calls map_worker makes */
+template <class K, class V>
+class mutex_map
+{
+public:
+	typedef ft::map<K, V, std::less<K>, typename bench_alloc<ft::pair<const K, V> >::type>	map_type;
+	typedef typename map_type::value_type	value_type;
+
+private:
+	pthread_mutex_t	_lock;
+	map_type		_map;
+
+public:
+	mutex_map() { ::pthread_mutex_init(&_lock, 0); }
+	~mutex_map() { ::pthread_mutex_destroy(&_lock); }
+
+	void insert(const value_type& x)
+	{
+		::pthread_mutex_lock(&_lock);
+		_map.insert(x);
+		::pthread_mutex_unlock(&_lock);
+	}
+
+	void erase(const K& k)
+	{
+		::pthread_mutex_lock(&_lock);
+		_map.erase(k);
+		::pthread_mutex_unlock(&_lock);
+	}
+
+	bool lookup(const K& k, V& out)
+	{
+		::pthread_mutex_lock(&_lock);
+		typename map_type::iterator it = _map.find(k);
+		bool ok = it != _map.end();
+		if (ok)
+			out = it->second;
+		::pthread_mutex_unlock(&_lock);
+		return ok;
+	}
+};
+
+/* every thread does _ops random operations on keys below _range: _write_pct percent insert or erase, the rest lookups */
+template <class Map>
+struct map_worker
+{
+	Map*		_map;
+	std::size_t	_ops;
+	std::size_t	_range;
+	unsigned	_write_pct;
+	unsigned	_threads;
+	unsigned	_next_id;
+	std::size_t	_hits;
+	start_gate	_gate;
+
+	static void* entry(void* arg)
+	{
+		map_worker* w = static_cast<map_worker*>(arg);
+		std::size_t state = __atomic_add_fetch(&w->_next_id, 1, __ATOMIC_RELAXED);
+		w->_gate.arrive_and_wait(w->_threads + 1);
+		std::size_t hits = 0;
+		long v;
+		for (std::size_t i = 0; i < w->_ops; ++i)
+		{
+			std::size_t r = next_random(state);
+			long k = long(r % w->_range);
+			unsigned dice = unsigned((r >> 20) % 100);
+			if (dice < w->_write_pct / 2)
+				w->_map->insert(typename Map::value_type(k, k));
+			else if (dice < w->_write_pct)
+				w->_map->erase(k);
+			else
+				hits += w->_map->lookup(k, v);
+		}
+		__atomic_add_fetch(&w->_hits, hits, __ATOMIC_RELAXED);
+		return 0;
+	}
+};
+
+/* the map starts with every even key below 2 * size, so lookups hit half the time */
+template <class Map>
+void bench_map_threads(reporter& out, const char* container, const char* op,
+		std::size_t size, std::size_t ops, unsigned threads, unsigned write_pct)
+{
+	Map m;
+	for (std::size_t i = 0; i < size; ++i)
+		m.insert(typename Map::value_type(long(2 * i), long(2 * i)));
+	map_worker<Map> w;
+	w._map = &m;
+	w._ops = ops;
+	w._range = 2 * size;
+	w._write_pct = write_pct;
+	w._threads = threads;
+	w._next_id = 0;
+	w._hits = 0;
+	ft::alloc_counters before = stats::snapshot();
+	double ns = run_threads(w, threads);
+	ft::alloc_counters after = stats::snapshot();
+	g_sink = w._hits;
+	double total = double(ops) * threads;
+	out.row(container, "long", op, size, threads, ns / total,
+			double(after.allocations - before.allocations) / total, rss_kb());
+}
+
+/* every thread does _ops push + pop pairs on the shared stack */
+template <class Stack>
+struct stack_worker
+{
+	Stack*		_stack;
+	std::size_t	_ops;
+	start_gate	_gate;
+	unsigned	_threads;
+
+	static void* entry(void* arg)
+	{
+		stack_worker* w = static_cast<stack_worker*>(arg);
+		w->_gate.arrive_and_wait(w->_threads + 1);
+		long x;
+		for (std::size_t i = 0; i < w->_ops; ++i)
+		{
+			w->_stack->push(long(i));
+			while (!w->_stack->pop(x))
+				::sched_yield();
+		}
+		return 0;
+	}
+};
+
+template <class Stack>
+void bench_stack_threads(reporter& out, const char* container, std::size_t ops, unsigned threads)
+{
+	Stack s;
+	stack_worker<Stack> w;
+	w._stack = &s;
+	w._ops = ops;
+	w._threads = threads;
+	ft::alloc_counters before = stats::snapshot();
+	double ns = run_threads(w, threads);
+	ft::alloc_counters after = stats::snapshot();
+	double total = double(ops) * threads;
+	out.row(container, "long", "push_pop", ops, threads, ns / total,
+			double(after.allocations - before.allocations) / total, rss_kb());
+}
+
+/* producers push _items each, consumers pop until all are drained */
+template <class Queue>
+struct queue_worker
+{
+	Queue*		_queue;
+	std::size_t	_items;
+	unsigned	_producers;
+	unsigned	_threads;
+	std::size_t	_popped;
+	unsigned	_next_id;
+	start_gate	_gate;
+
+	static void* entry(void* arg)
+	{
+		queue_worker* w = static_cast<queue_worker*>(arg);
+		unsigned id = __atomic_fetch_add(&w->_next_id, 1, __ATOMIC_RELAXED);
+		std::size_t total = w->_items * w->_producers;
+		w->_gate.arrive_and_wait(w->_threads + 1);
+		if (id < w->_producers)
+		{
+			for (std::size_t i = 0; i < w->_items; ++i)
+				while (!w->_queue->push(long(i)))
+					::sched_yield();
+			return 0;
+		}
+		long x;
+		while (__atomic_load_n(&w->_popped, __ATOMIC_RELAXED) < total)
+		{
+			if (w->_queue->pop(x))
+				__atomic_add_fetch(&w->_popped, 1, __ATOMIC_RELAXED);
+			else
+				::sched_yield();
+		}
+		return 0;
+	}
+};
+
+template <class Queue>
+void bench_queue(reporter& out, const char* container, std::size_t items, unsigned pairs)
+{
+	{
+		/* latency: one thread, push then pop */
+		Queue q(1024);
+		long x;
+		ft::alloc_counters before = stats::snapshot();
+		double start = now_ns();
+		for (std::size_t i = 0; i < items; ++i)
+		{
+			q.push(long(i));
+			q.pop(x);
+		}
+		double ns = now_ns() - start;
+		ft::alloc_counters after = stats::snapshot();
+		if (pairs == 1)
+			out.row(container, "long", "round_trip", items, 1, ns / items,
+					double(after.allocations - before.allocations) / items, rss_kb());
+	}
+	/* throughput: pairs producers and pairs consumers */
+	Queue q(1024);
+	queue_worker<Queue> w;
+	w._queue = &q;
+	w._items = items / pairs;
+	w._producers = pairs;
+	w._threads = 2 * pairs;
+	w._popped = 0;
+	w._next_id = 0;
+	ft::alloc_counters before = stats::snapshot();
+	double ns = run_threads(w, 2 * pairs);
+	ft::alloc_counters after = stats::snapshot();
+	double total = double(w._items) * pairs;
+	out.row(container, "long", "transfer", items, 2 * pairs, ns / total,
+			double(after.allocations - before.allocations) / total, rss_kb());
+}
+
+typedef ft::ring_queue<long, ft::spsc, bench_alloc<long>::type>	spsc_queue;
+typedef ft::ring_queue<long, ft::mpmc, bench_alloc<long>::type>	mpmc_queue;
+typedef ft::skiplist_map<long, long, std::less<long>, bench_alloc<ft::pair<const long, long> >::type>	skiplist_long;
+
+static void bench_concurrent(reporter& out, unsigned max_threads)
+{
+	const std::size_t stack_ops = 100000;
+	for (unsigned t = 1; t <= max_threads; t *= 2)
+	{
+		bench_stack_threads<ft::concurrent_stack<long, bench_alloc<long>::type> >(out, "concurrent_stack", stack_ops, t);
+		bench_stack_threads<mutex_stack<long> >(out, "mutex_stack", stack_ops, t);
+	}
+	const std::size_t items = 1000000;
+	bench_queue<spsc_queue>(out, "ring_queue_spsc", items, 1);
+	for (unsigned pairs = 1; 2 * pairs <= max_threads && pairs <= 4; pairs *= 2)
+	{
+		bench_queue<mpmc_queue>(out, "ring_queue_mpmc", items, pairs);
+		bench_queue<mutex_queue<long> >(out, "mutex_queue", items, pairs);
+	}
+	const std::size_t map_size = 100000;
+	const std::size_t map_ops = 100000;
+	const char* mixes[] = { "read_only", "read_90", "read_50" };
+	const unsigned write_pct[] = { 0, 10, 50 };
+	for (unsigned m = 0; m < 3; ++m)
+		for (unsigned t = 1; t <= max_threads; t *= 2)
+		{
+			bench_map_threads<skiplist_long>(out, "skiplist_map", mixes[m], map_size, map_ops, t, write_pct[m]);
+			bench_map_threads<mutex_map<long, long> >(out, "mutex_map", mixes[m], map_size, map_ops, t, write_pct[m]);
+		}
+}
+#endif
+
+//section: main
+static std::vector<std::size_t> parse_sizes(const char* arg)
+{
+	std::vector<std::size_t> sizes;
+	while (*arg)
+	{
+		char* end;
+		unsigned long n = std::strtoul(arg, &end, 10);
+		if (end == arg)
+			break ;
+		if (n)
+			sizes.push_back(n);
+		arg = *end == ',' ? end + 1 : end;
+	}
+	return sizes;
+}
+
+int main(int argc, char** argv)
+{
+	bool json = false;
+	unsigned max_threads = 64;
+	std::vector<std::size_t> sizes;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!std::strcmp(argv[i], "--json"))
+			json = true;
+		else if (!std::strcmp(argv[i], "--sizes") && i + 1 < argc)
+			sizes = parse_sizes(argv[++i]);
+		else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+			max_threads = std::strtoul(argv[++i], 0, 10);
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--json] [--sizes 1000,100000] [--threads 64]" << std::endl;
+			return 1;
+		}
+	}
+	if (sizes.empty())
+		sizes = parse_sizes("1000,10000,100000,1000000");
+
+	reporter out(json);
+	for (std::size_t i = 0; i < sizes.size(); ++i)
+	{
+		std::size_t n = sizes[i];
+		bench_vector<int>(out, n);
+		bench_vector<std::string>(out, n);
+		bench_deque<int>(out, n);
+		bench_deque<std::string>(out, n);
+		bench_buffer(out, n);
+		bench_map<int>(out, n);
+		bench_map<std::string>(out, n);
+		bench_set<int>(out, n);
+		bench_set<std::string>(out, n);
+		bench_priority_queue<int>(out, n);
+		bench_priority_queue<std::string>(out, n);
+		bench_schedule(out, n);
+#ifndef BENCH_STD
+		bench_stable_vector<int>(out, n);
+		bench_stable_vector<std::string>(out, n);
+		bench_io_buffer(out, n);
+		bench_vector<ft::string>(out, n);
+		bench_map<ft::string>(out, n);
+		bench_radix(out, n);
+		bench_lru(out, n);
+		bench_startup(out, n);
+		bench_parallel(out, n, max_threads);
+#endif
+	}
+#ifndef BENCH_STD
+	bench_find_cold(out);
+	bench_concurrent(out, max_threads);
+#else
+	(void)max_threads;
+#endif
+	return 0;
+}
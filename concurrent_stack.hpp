@@ -0,0 +1,189 @@
+#ifndef CONCURRENT_STACK_HPP
+# define CONCURRENT_STACK_HPP
+
+# include <memory>
+# include <cstddef>
+# include <stdexcept>
+# include "./iter/iterator_stable_vector.hpp"
+
+namespace ft
+{
+/*
+* Lock-free LIFO (Treiber stack) for producer/consumer threads.
+* Nodes live in a pool of chunks of 16, 32, 64... nodes (the
+* stable_vector_chunks layout) and are never freed before the destructor,
+* so reading a stale head->next is safe. Popped nodes go to a second
+* lock-free list and are reused by push: steady-state push/pop never touch
+* the allocator. Lists link 32-bit node indices, not pointers, so a list
+* head is a 64-bit word {version, index} and one plain 64-bit CAS covers
+* both: no assumption on the bits of a user pointer, no 16-byte CAS. The
+* 32-bit version would have to wrap while a thread sits between its load
+* and its CAS to reopen ABA. Uses the GCC/clang __atomic builtins.
+*/
+	template <class T,
+				class Allocator = std::allocator<T> >
+	class concurrent_stack
+	{
+	public:
+		typedef				T												value_type;
+		typedef				Allocator										allocator_type;
+		typedef				std::size_t										size_type;
+
+	private:
+		/* index 0 is the end of a list, node i is pool slot i - 1 */
+		typedef				unsigned int									node_index;
+		typedef				unsigned long long								tagged_index;
+
+		struct Node
+		{
+			node_index	_next;
+			T			_value;
+		};
+
+		typedef typename	allocator_type::template rebind<Node>::other	allocator_node;
+		typedef				stable_vector_chunks							chunks;
+
+		enum { max_chunks = sizeof(node_index) * 8 - chunks::shift };
+
+		allocator_node		_alloc_node;
+		allocator_type		_alloc_value;
+		tagged_index		_head;
+		tagged_index		_free;
+		size_type			_size;
+		size_type			_nchunks;	/* chunks claimed, a claimed one may still be NULL */
+		Node*				_chunks[max_chunks];
+
+		concurrent_stack(const concurrent_stack&);
+		concurrent_stack& operator=(const concurrent_stack&);
+
+	public:
+		explicit concurrent_stack(const allocator_type& alloc = allocator_type()):
+			_alloc_node(alloc),
+			_alloc_value(alloc),
+			_head(0),
+			_free(0),
+			_size(0),
+			_nchunks(0)
+		{
+			for (size_type k = 0; k < size_type(max_chunks); ++k)
+				_chunks[k] = NULL;
+		}
+
+		~concurrent_stack()
+		{
+			for (node_index i = _index(_head); i; i = _node(i)->_next)
+				_alloc_value.destroy(&_node(i)->_value);
+			for (size_type k = 0; k < _nchunks; ++k)
+				if (_chunks[k])
+					_alloc_node.deallocate(_chunks[k], chunks::size(k));
+		}
+
+		bool empty() const { return _index(__atomic_load_n(&_head, __ATOMIC_ACQUIRE)) == 0; }
+		size_type size() const { return __atomic_load_n(&_size, __ATOMIC_RELAXED); }
+
+		void push(const value_type& x)
+		{
+			node_index i;
+			while ((i = _pop_node(_free)) == 0)
+				_grow();
+			try
+			{
+				_alloc_value.construct(&_node(i)->_value, x);
+			}
+			catch (...)
+			{
+				_push_list(_free, i, i);
+				throw ;
+			}
+			_push_list(_head, i, i);
+			__atomic_add_fetch(&_size, 1, __ATOMIC_RELAXED);
+		}
+
+		/* false when the stack was empty, x is left untouched then */
+		bool pop(value_type& x)
+		{
+			node_index i = _pop_node(_head);
+			if (i == 0)
+				return false;
+			__atomic_sub_fetch(&_size, 1, __ATOMIC_RELAXED);
+			Node* node = _node(i);
+			x = node->_value;
+			_alloc_value.destroy(&node->_value);
+			_push_list(_free, i, i);
+			return true;
+		}
+
+		/* fill the node pool so the first n pushes do not allocate either */
+		void reserve(size_type n)
+		{
+			while (chunks::total(__atomic_load_n(&_nchunks, __ATOMIC_ACQUIRE)) < n)
+				_grow();
+		}
+
+	private:
+		static node_index _index(tagged_index word) { return node_index(word); }
+
+		static tagged_index _make(node_index i, tagged_index old)
+		{
+			return (((old >> 32) + 1) << 32) | i;
+		}
+
+		Node* _node(node_index i) const { return &chunks::at(_chunks, i - 1); }
+
+		/*
+		* Claims the next chunk slot with a CAS, so concurrent pushers that
+		* all found the free list empty each add a chunk instead of waiting
+		* for one another. The nodes reach _free only after the chunk pointer
+		* is stored: whoever pops their index also sees the chunk.
+		*/
+		void _grow()
+		{
+			size_type k = __atomic_load_n(&_nchunks, __ATOMIC_RELAXED);
+			do
+			{
+				if (k == size_type(max_chunks))
+					throw (std::length_error("concurrent_stack"));
+			}
+			while (!__atomic_compare_exchange_n(&_nchunks, &k, k + 1,
+						true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+			Node* chunk = _alloc_node.allocate(chunks::size(k));
+			__atomic_store_n(&_chunks[k], chunk, __ATOMIC_RELEASE);
+			node_index first = node_index(chunks::total(k)) + 1;
+			node_index last = first + node_index(chunks::size(k)) - 1;
+			for (node_index i = first; i < last; ++i)
+				chunk[i - first]._next = i + 1;
+			_push_list(_free, first, last);
+		}
+
+		/* links first..last (already chained through _next) in front of list */
+		void _push_list(tagged_index& list, node_index first, node_index last)
+		{
+			Node* tail = _node(last);
+			tagged_index old = __atomic_load_n(&list, __ATOMIC_RELAXED);
+			do
+			{
+				__atomic_store_n(&tail->_next, _index(old), __ATOMIC_RELAXED);
+			}
+			while (!__atomic_compare_exchange_n(&list, &old, _make(first, old),
+						true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+		}
+
+		node_index _pop_node(tagged_index& list)
+		{
+			tagged_index old = __atomic_load_n(&list, __ATOMIC_ACQUIRE);
+			node_index i;
+			do
+			{
+				i = _index(old);
+				if (i == 0)
+					return 0;
+			}
+			while (!__atomic_compare_exchange_n(&list, &old,
+						_make(__atomic_load_n(&_node(i)->_next, __ATOMIC_RELAXED), old),
+						true, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+			return i;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,455 @@
+#ifndef DEQUE_HPP
+# define DEQUE_HPP
+
+# include <memory>
+# include <stdexcept>
+# include <algorithm>
+# include "./utils/utils.hpp"
+# include "./iter/iterator_deque.hpp"
+# include "./iter/iterator_reverse.hpp"
+
+namespace ft
+{
+/*
+* Double-ended queue over fixed-size blocks (deque_block<T>::size elements)
+* and a map of block pointers. Elements are never relocated when the deque
+* grows: a full map only copies block pointers. Only the blocks covering
+* [_start, _start + _size) are in the map. A block that pop_front/pop_back
+* leave is kept as the spare, which the next new block reuses, so push/pop
+* at a block boundary or on an empty deque do not allocate. _start is an absolute index into the map,
+* so iterators are (map, index) pairs and random access is one division.
+*/
+	template <class T,
+				class Allocator = std::allocator<T> >
+	class deque
+	{
+	public:
+		typedef				T												value_type;
+		typedef				Allocator										allocator_type;
+		typedef typename	Allocator::pointer								pointer;
+		typedef typename	Allocator::const_pointer						const_pointer;
+		typedef				std::size_t										size_type;
+		typedef typename	Allocator::reference							reference;
+		typedef typename	Allocator::const_reference						const_reference;
+		typedef				std::ptrdiff_t									difference_type;
+		typedef				ft::deque_iterator<value_type>					iterator;
+		typedef				ft::deque_iterator<const value_type>			const_iterator;
+		typedef				ft::reverse_iterator<iterator>					reverse_iterator;
+		typedef				ft::reverse_iterator<const_iterator>			const_reverse_iterator;
+	private:
+		typedef typename	Allocator::template rebind<pointer>::other		allocator_map;
+
+		enum { block = deque_block<value_type>::size };
+
+		allocator_type	_alloc;
+		allocator_map	_alloc_map;
+		pointer*		_map;
+		size_type		_map_size;
+		pointer			_spare;		/* last released block, or NULL */
+		size_type		_start;
+		size_type		_size;
+	public:
+//(1) empty container constructor (default constructor):
+		explicit deque(const Allocator& alloc = Allocator()):
+			_alloc(alloc),
+			_alloc_map(alloc),
+			_map(t_nullptr),
+			_map_size(0),
+			_spare(t_nullptr),
+			_start(0),
+			_size(0)
+		{}
+//(2) fill constructor:
+		explicit deque(size_type n,
+						const value_type& value = value_type(),
+						const allocator_type& alloc = allocator_type()):
+			_alloc(alloc),
+			_alloc_map(alloc),
+			_map(t_nullptr),
+			_map_size(0),
+			_spare(t_nullptr),
+			_start(0),
+			_size(0)
+		{
+			assign(n, value);
+		}
+//(3) range constructor:
+		template <class InputIterator>
+		deque(InputIterator first,
+				InputIterator last,
+				const allocator_type& alloc = allocator_type(),
+				typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type* = t_nullptr):
+			_alloc(alloc),
+			_alloc_map(alloc),
+			_map(t_nullptr),
+			_map_size(0),
+			_spare(t_nullptr),
+			_start(0),
+			_size(0)
+		{
+			assign(first, last);
+		}
+//(4) copy constructor:
+		deque(const deque& x):
+			_alloc(x._alloc),
+			_alloc_map(x._alloc_map),
+			_map(t_nullptr),
+			_map_size(0),
+			_spare(t_nullptr),
+			_start(0),
+			_size(0)
+		{
+			assign(x.begin(), x.end());
+		}
+//Destructor:
+		~deque()
+		{
+			clear();
+			if (_spare)
+				_alloc.deallocate(_spare, block);
+			if (_map)
+				_alloc_map.deallocate(_map, _map_size);
+		}
+//Assign content:
+		deque& operator=(const deque& x)
+		{
+			if (this != &x)
+				assign(x.begin(), x.end());
+			return (*this);
+		}
+
+		template <class InputIterator>
+		void assign(InputIterator first,
+					InputIterator last,
+					typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type* = t_nullptr)
+		{
+			clear();
+			for (; first != last; ++first)
+				push_back(*first);
+		}
+
+		void assign(size_type n, const T& u)
+		{
+			clear();
+			for (size_type i = 0; i < n; i++)
+				push_back(u);
+		}
+
+		allocator_type get_allocator() const { return _alloc; }
+
+//iterators:
+		iterator begin() { return iterator(_map, _start); }
+		const_iterator begin() const { return const_iterator(_map, _start); }
+		iterator end() { return iterator(_map, _start + _size); }
+		const_iterator end() const { return const_iterator(_map, _start + _size); }
+		reverse_iterator rbegin() { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+		reverse_iterator rend() { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+//capacity:
+		size_type size() const { return _size; }
+		size_type max_size() const { return allocator_type().max_size(); }
+		/* heap bytes held: the block map and the allocated blocks, spare included */
+		size_type memory_usage() const
+		{
+			size_type blocks = _size ? (_start + _size - 1) / block - _start / block + 1 : 0;
+			if (_spare)
+				blocks++;
+			return _map_size * sizeof(pointer) + blocks * block * sizeof(value_type);
+		}
+		bool empty() const { return _size == 0; }
+
+		void resize(size_type sz, T c = T())
+		{
+			if (sz > max_size())
+				throw (std::length_error("deque"));
+			while (_size > sz)
+				pop_back();
+			while (_size < sz)
+				push_back(c);
+		}
+
+//element access:
+		reference operator[](size_type n) { return _at(_start + n); }
+		const_reference operator[](size_type n) const { return _at(_start + n); }
+		reference front() { return _at(_start); }
+		const_reference front() const { return _at(_start); }
+		reference back() { return _at(_start + _size - 1); }
+		const_reference back() const { return _at(_start + _size - 1); }
+
+		reference at(size_type n)
+		{
+			if (n >= _size)
+				throw (std::out_of_range("deque"));
+			return ((*this)[n]);
+		}
+
+		const_reference at(size_type n) const
+		{
+			if (n >= _size)
+				throw (std::out_of_range("deque"));
+			return ((*this)[n]);
+		}
+
+//Modifiers:
+		void push_back(const value_type& value)
+		{
+			FT_PERF_SCOPE("deque::push_back");
+			if ((_start + _size) / block >= _map_size)
+				_reserve_map(false);
+			size_type g = _start + _size;
+			_construct(g, value, _size == 0 || g % block == 0);
+			++_size;
+		}
+
+		void push_front(const value_type& value)
+		{
+			FT_PERF_SCOPE("deque::push_front");
+			if (_start == 0)
+				_reserve_map(true);
+			size_type g = _start - 1;
+			_construct(g, value, _size == 0 || _start % block == 0);
+			_start = g;
+			++_size;
+		}
+
+		void pop_back()
+		{
+			size_type g = _start + _size - 1;
+			_alloc.destroy(&_at(g));
+			--_size;
+			if (_size == 0 || g % block == 0)
+				_release_block(g / block);
+		}
+
+		void pop_front()
+		{
+			size_type g = _start;
+			_alloc.destroy(&_at(g));
+			++_start;
+			--_size;
+			if (_size == 0 || _start % block == 0)
+				_release_block(g / block);
+		}
+
+		/* grows at the nearer end and shifts only the elements on that side */
+		iterator insert(iterator position, const T& x)
+		{
+			FT_PERF_SCOPE("deque::insert");
+			size_type idx = position - begin();
+			value_type copy(x);
+			if (idx < _size / 2)
+			{
+				push_front(front());
+				for (size_type i = 1; i < idx; i++)
+					(*this)[i] = (*this)[i + 1];
+			}
+			else
+			{
+				push_back(_size ? back() : copy);
+				for (size_type i = _size - 1; i > idx; i--)
+					(*this)[i] = (*this)[i - 1];
+			}
+			(*this)[idx] = copy;
+			return begin() + idx;
+		}
+
+		void insert(iterator position, size_type n, const T& x)
+		{
+			size_type idx = position - begin();
+			size_type old_size = _size;
+			for (size_type i = 0; i < n; i++)
+				push_back(x);
+			_rotate(idx, old_size, _size);
+		}
+
+		template <class InputIterator>
+		void insert(iterator position,
+					InputIterator first,
+					InputIterator last,
+					typename enable_if<!is_integral<InputIterator>::value>::type* = 0)
+		{
+			size_type idx = position - begin();
+			size_type old_size = _size;
+			for (; first != last; ++first)
+				push_back(*first);
+			_rotate(idx, old_size, _size);
+		}
+
+		iterator erase(iterator position)
+		{
+			return erase(position, position + 1);
+		}
+
+		/* closes the gap from the shorter side */
+		iterator erase(iterator first, iterator last)
+		{
+			FT_PERF_SCOPE("deque::erase");
+			size_type idx = first - begin();
+			size_type n = last - first;
+			if (n == 0)
+				return first;
+			if (idx < (_size - n) / 2)
+			{
+				for (size_type i = idx; i-- > 0; )
+					(*this)[i + n] = (*this)[i];
+				for (size_type i = 0; i < n; i++)
+					pop_front();
+			}
+			else
+			{
+				for (size_type i = idx + n; i < _size; i++)
+					(*this)[i - n] = (*this)[i];
+				for (size_type i = 0; i < n; i++)
+					pop_back();
+			}
+			return begin() + idx;
+		}
+
+		void swap(deque& x)
+		{
+			std::swap(_alloc, x._alloc);
+			std::swap(_alloc_map, x._alloc_map);
+			std::swap(_map, x._map);
+			std::swap(_map_size, x._map_size);
+			std::swap(_spare, x._spare);
+			std::swap(_start, x._start);
+			std::swap(_size, x._size);
+		}
+
+		/* keeps the block map, the next push starts from its middle */
+		void clear()
+		{
+			while (_size)
+				pop_back();
+			_start = (_map_size / 2) * block;
+		}
+
+	private:
+		reference _at(size_type g) const { return _map[g / block][g % block]; }
+
+		void _construct(size_type g, const value_type& value, bool new_block)
+		{
+			if (new_block)
+			{
+				if (_spare)
+				{
+					_map[g / block] = _spare;
+					_spare = t_nullptr;
+				}
+				else
+					_map[g / block] = _alloc.allocate(block);
+			}
+			try
+			{
+				_alloc.construct(&_at(g), value);
+			}
+			catch (...)
+			{
+				if (new_block)
+					_release_block(g / block);
+				throw ;
+			}
+		}
+
+		/* keeps one block for the next _construct, frees the others */
+		void _release_block(size_type b)
+		{
+			if (_spare)
+				_alloc.deallocate(_map[b], block);
+			else
+				_spare = _map[b];
+			_map[b] = t_nullptr;
+		}
+
+		/*
+		* Make room for one more block at the front or at the back: recenter
+		* the used block pointers if the map is less than half full, else
+		* double it. Elements stay where they are, _start moves with them.
+		*/
+		void _reserve_map(bool at_front)
+		{
+			size_type first = _start / block;
+			size_type used = _size ? (_start + _size - 1) / block - first + 1 : 0;
+			size_type need = used + 1;
+			pointer* map = _map;
+			size_type map_size = _map_size;
+			if (_map_size <= 2 * need)
+			{
+				map_size = _map_size * 2 > need + 2 ? _map_size * 2 : need + 2;
+				map = _alloc_map.allocate(map_size);
+			}
+			size_type new_first = (map_size - need) / 2 + (at_front ? 1 : 0);
+			if (map != _map || new_first < first)
+				for (size_type i = 0; i < used; i++)
+					map[new_first + i] = _map[first + i];
+			else
+				for (size_type i = used; i-- > 0; )
+					map[new_first + i] = _map[first + i];
+			if (map != _map)
+			{
+				if (_map)
+					_alloc_map.deallocate(_map, _map_size);
+				_map = map;
+				_map_size = map_size;
+			}
+			_start = new_first * block + _start % block;
+		}
+
+		/* moves [mid, last) in front of [first, mid) with three reversals */
+		void _rotate(size_type first, size_type mid, size_type last)
+		{
+			_reverse(first, mid);
+			_reverse(mid, last);
+			_reverse(first, last);
+		}
+
+		void _reverse(size_type first, size_type last)
+		{
+			while (first + 1 < last)
+				std::swap((*this)[first++], (*this)[--last]);
+		}
+
+	public:
+		friend bool operator==(const deque<T,Allocator>& x, const deque<T,Allocator>& y)
+		{
+			if (x.size() != y.size())
+				return false;
+			return ft::equal(x.begin(), x.end(), y.begin());
+		}
+
+		friend bool operator!=(const deque<T,Allocator>& x, const deque<T,Allocator>& y)
+		{
+			return !(x == y);
+		}
+
+		friend bool operator< (const deque<T,Allocator>& x, const deque<T,Allocator>& y)
+		{
+			return ft::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end());
+		}
+
+		friend bool operator> (const deque<T,Allocator>& x, const deque<T,Allocator>& y)
+		{
+			return y < x;
+		}
+
+		friend bool operator<=(const deque<T,Allocator>& x, const deque<T,Allocator>& y)
+		{
+			return !(y < x);
+		}
+
+		friend bool operator>=(const deque<T,Allocator>& x, const deque<T,Allocator>& y)
+		{
+			return !(x < y);
+		}
+	};
+
+	template <class T, class Allocator>
+	void swap(deque<T,Allocator>& x, deque<T,Allocator>& y)
+	{
+		x.swap(y);
+	}
+}
+
+#endif
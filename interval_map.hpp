@@ -0,0 +1,282 @@
+#ifndef INTERVAL_MAP_HPP
+# define INTERVAL_MAP_HPP
+
+# include <memory>
+# include "./tree/RBTree.hpp"
+# include "./utils/utils.hpp"
+
+namespace ft
+{
+	/* closed range [lo, hi], lo must not be greater than hi */
+	template <class Key>
+	struct interval
+	{
+		Key	lo;
+		Key	hi;
+
+		interval(): lo(), hi() {}
+		interval(const Key& l, const Key& h): lo(l), hi(h) {}
+	};
+
+	/* the stored element: the user's pair plus the largest hi of its subtree */
+	template <class Key, class T>
+	struct interval_map_entry: public ft::pair<const interval<Key>, T>
+	{
+		typedef ft::pair<const interval<Key>, T>	value_type;
+
+		Key	_max_end;
+
+		interval_map_entry(const value_type& x): value_type(x), _max_end(x.first.hi) {}
+	};
+
+	/* keeps _max_end = max(hi, left _max_end, right _max_end) */
+	struct interval_augment
+	{
+		enum { enabled = 1 };
+
+		template<class Node, class Compare>
+		static void update(Node* x, const Node* nil, const Compare& comp)
+		{
+			x->_value._max_end = x->_value.first.hi;
+			if (x->_left != nil && comp.comp(x->_value._max_end, x->_left->_value._max_end))
+				x->_value._max_end = x->_left->_value._max_end;
+			if (x->_right != nil && comp.comp(x->_value._max_end, x->_right->_value._max_end))
+				x->_value._max_end = x->_right->_value._max_end;
+		}
+	};
+
+/*
+* Map keyed by closed intervals, ordered by lo then hi, on an RBTree whose
+* nodes also hold the largest hi of their subtree. overlapping(lo, hi)
+* skips every subtree that ends before lo and stops at the first start
+* after hi, so a query costs O(log n) per reported interval at worst and
+* close to O(log n + k) in practice. Iterators yield interval_map_entry,
+* which is a pair<const interval<Key>, T>.
+*/
+	template <class Key,
+				class T,
+				class Compare = std::less<Key>,
+				class Allocator = std::allocator<ft::pair<const interval<Key>, T> > >
+	class interval_map
+	{
+	public:
+		typedef				interval<Key>									key_type;
+		typedef				Key												point_type;
+		typedef				T												mapped_type;
+		typedef				ft::pair<const key_type, T>						value_type;
+		typedef				interval_map_entry<Key, T>						entry_type;
+		typedef				Compare											key_compare;
+		typedef				Allocator										allocator_type;
+		typedef typename	Allocator::size_type							size_type;
+		typedef typename	Allocator::difference_type						difference_type;
+
+		/* orders entries by lo, then by hi */
+		class entry_compare
+		{
+		public:
+			Compare	comp;
+
+			entry_compare(Compare c): comp(c) {}
+
+			bool operator()(const entry_type& x, const entry_type& y) const
+			{
+				if (comp(x.first.lo, y.first.lo))
+					return true;
+				if (comp(y.first.lo, x.first.lo))
+					return false;
+				return comp(x.first.hi, y.first.hi);
+			}
+		};
+
+		typedef typename	Allocator::template rebind<entry_type>::other	entry_allocator;
+		typedef RBTree<entry_type, entry_compare, entry_allocator, interval_augment>	tree_type;
+		typedef typename	tree_type::iterator								iterator;
+		typedef typename	tree_type::const_iterator						const_iterator;
+		typedef typename	tree_type::reverse_iterator						reverse_iterator;
+		typedef typename	tree_type::const_reverse_iterator				const_reverse_iterator;
+
+	private:
+		typedef typename	tree_type::node_pointer							node_pointer;
+
+		allocator_type	_alloc;
+		tree_type		_tree;
+		key_compare		_comp;
+
+	public:
+// construct/copy/destroy:
+		explicit interval_map(const Compare& comp = Compare(),
+						const Allocator& alloc = Allocator()):
+			_alloc(alloc),
+			_tree(entry_compare(comp), entry_allocator(alloc)),
+			_comp(comp)
+		{}
+
+		template <class InputIterator>
+		interval_map(InputIterator first, InputIterator last,
+				const Compare& comp = Compare(),
+				const Allocator& alloc = Allocator()):
+			_alloc(alloc),
+			_tree(entry_compare(comp), entry_allocator(alloc)),
+			_comp(comp)
+		{
+			insert(first, last);
+		}
+
+		interval_map(const interval_map& x):
+			_alloc(x._alloc),
+			_tree(x._tree),
+			_comp(x._comp)
+		{}
+
+		interval_map& operator=(const interval_map& x)
+		{
+			if (&x == this)
+				return *this;
+			_tree = x._tree;
+			_alloc = x._alloc;
+			_comp = x._comp;
+			return *this;
+		}
+
+		allocator_type get_allocator() const { return _alloc; }
+
+// iterators:
+		iterator begin() { return _tree.begin(); }
+		const_iterator begin() const { return _tree.begin(); }
+		iterator end() { return _tree.end(); }
+		const_iterator end() const { return _tree.end(); }
+		reverse_iterator rbegin() { return _tree.rbegin(); }
+		const_reverse_iterator rbegin() const { return _tree.rbegin(); }
+		reverse_iterator rend() { return _tree.rend(); }
+		const_reverse_iterator rend() const { return _tree.rend(); }
+
+// capacity:
+		bool empty() const { return _tree.empty(); }
+		size_type size() const { return _tree.size(); }
+		size_type max_size() const { return _tree.max_size(); }
+		size_type memory_usage() const { return _tree.memory_usage(); }
+
+// element access:
+		T& operator[](const key_type& x)
+		{
+			return insert(value_type(x, mapped_type())).first->second;
+		}
+
+// modifiers:
+		pair<iterator, bool> insert(const value_type& x)
+		{
+			return _tree.insert(entry_type(x));
+		}
+
+		template <class InputIterator>
+		void insert(InputIterator first, InputIterator last)
+		{
+			while (first != last)
+				insert(value_type(*first++));
+		}
+
+		void erase(iterator position)
+		{
+			_tree.erase(*position);
+		}
+
+		size_type erase(const key_type& x)
+		{
+			return _tree.erase(_probe(x));
+		}
+
+		void swap(interval_map& other)
+		{
+			_tree.swap(other._tree);
+			std::swap(_alloc, other._alloc);
+			std::swap(_comp, other._comp);
+		}
+
+		void clear()
+		{
+			_tree.clear();
+		}
+
+// observers:
+		key_compare key_comp() const { return _comp; }
+
+// operations:
+		/* exact interval lookup */
+		iterator find(const key_type& x) { return _tree.find(_probe(x)); }
+		const_iterator find(const key_type& x) const { return _tree.find(_probe(x)); }
+		size_type count(const key_type& x) const { return _tree.count(_probe(x)); }
+
+		/* writes an iterator to every entry meeting [lo, hi] to out, ordered by key */
+		template <class OutputIt>
+		OutputIt overlapping(const Key& lo, const Key& hi, OutputIt out)
+		{
+			return _overlapping<iterator>(_tree._root, lo, hi, out);
+		}
+
+		template <class OutputIt>
+		OutputIt overlapping(const Key& lo, const Key& hi, OutputIt out) const
+		{
+			return _overlapping<const_iterator>(_tree._root, lo, hi, out);
+		}
+
+		/* entries containing point */
+		template <class OutputIt>
+		OutputIt stab(const Key& point, OutputIt out)
+		{
+			return overlapping(point, point, out);
+		}
+
+		template <class OutputIt>
+		OutputIt stab(const Key& point, OutputIt out) const
+		{
+			return overlapping(point, point, out);
+		}
+
+		/* any entry meeting [lo, hi], end() if none: one descent */
+		iterator find_overlap(const Key& lo, const Key& hi)
+		{
+			node_pointer node = _tree._root;
+			while (node != _tree._nil)
+			{
+				if (!_comp(hi, node->_value.first.lo) && !_comp(node->_value.first.hi, lo))
+					return iterator(node);
+				/* the left subtree can only miss if it ends before lo */
+				if (node->_left != _tree._nil && !_comp(node->_left->_value._max_end, lo))
+					node = node->_left;
+				else
+					node = node->_right;
+			}
+			return end();
+		}
+
+	private:
+		entry_type _probe(const key_type& x) const
+		{
+			return entry_type(value_type(x, mapped_type()));
+		}
+
+		/* in order: left subtree, node, then the right subtree as the next iteration */
+		template <class It, class OutputIt>
+		OutputIt _overlapping(node_pointer node, const Key& lo, const Key& hi, OutputIt out) const
+		{
+			while (node != _tree._nil && !_comp(node->_value._max_end, lo))
+			{
+				out = _overlapping<It>(node->_left, lo, hi, out);
+				if (_comp(hi, node->_value.first.lo))
+					break ;
+				if (!_comp(node->_value.first.hi, lo))
+					*out++ = It(node);
+				node = node->_right;
+			}
+			return out;
+		}
+	};
+
+	template <class Key, class T, class Compare, class Alloc>
+	void swap(interval_map<Key, T, Compare, Alloc>& lhs, interval_map<Key, T, Compare, Alloc>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+}
+
+#endif
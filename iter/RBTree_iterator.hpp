@@ -2,12 +2,10 @@
 # define RBTREE_ITERATOR_HPP
 
 # include "../tree/RBTree_Node.hpp"
+# include "../utils/utils.hpp"
 
 namespace ft
 {
-	template<class T> struct remove_const { typedef T type; };
-	template<class T> struct remove_const <const T> { typedef T type; };
-
 	template<class Value>
 	class RBTree_iterator
 	{
@@ -27,60 +25,74 @@ namespace ft
 
 		node_pointer maximum(node_pointer node) const
 		{
-			while (node->_right->_type != nil)
+			while (!node->_right->is_nil())
 				node = node->_right;
 			return node;
 		}
 
 		node_pointer minimum(node_pointer node) const
 		{
-			while (node->_left->_type != nil)
+			while (!node->_left->is_nil())
 				node = node->_left;
 			return node;
 		}
 
 		void next()
 		{
-			if (_node->_type == nil)
+			FT_PERF_SCOPE("RBTree_iterator::next");
+# ifdef FT_RBTREE_THREADED
+			_node = _node->_next;
+			FT_PREFETCH(_node->_next);
+# else
+			if (_node->is_nil())
 				return ;
 
-			if (_node->_right->_type != nil)
+			/* the next step starts from the right child: fetch it early */
+			if (!_node->_right->is_nil())
 			{
 				_node = minimum(_node->_right);
+				FT_PREFETCH(_node->_right);
 				return ;
 			}	
-			node_pointer y = _node->_parent;
-			while (y->_type != nil && _node == y->_right)
+			node_pointer y = _node->parent();
+			while (!y->is_nil() && _node == y->_right)
 			{
 				_node = y;
-				y = y->_parent;
+				y = y->parent();
 			}
 			_node = y;
+			FT_PREFETCH(_node->_right);
+# endif
 		}
 
 		void previous()
 		{
-			if (_node->_type == nil)
+			FT_PERF_SCOPE("RBTree_iterator::previous");
+# ifdef FT_RBTREE_THREADED
+			_node = _node->_prev;
+# else
+			if (_node->is_nil())
 			{
-				_node = _node->_parent;
+				_node = _node->parent();
 				return ;
 			}
 
-			if (_node->_type != nil && _node->_left->_type != nil)
+			if (!_node->_left->is_nil())
 			{
 				_node = maximum(_node->_left);
 				return ;
 			}
 
-			node_pointer y = _node->_parent;
-			while (y->_type != nil && _node == y->_left)
+			node_pointer y = _node->parent();
+			while (!y->is_nil() && _node == y->_left)
 			{
 				_node = y;
-				y = y->_parent;
+				y = y->parent();
 			}
 
-			if (y->_type != nil)
+			if (!y->is_nil())
 				_node = y;
+# endif
 		}
 
 	public:
@@ -105,12 +117,12 @@ namespace ft
 
 		reference operator*() const
 		{
-			return *(_node->_value);
+			return _node->_value;
 		}
 
 		pointer operator->() const
 		{
-			return _node->_value;
+			return &_node->_value;
 		}
 
 
@@ -1,6 +1,8 @@
 #ifndef ITERATOR_HPP
 # define ITERATOR_HPP
 
+# include <iterator>
+
 namespace ft
 {
 	template <class Iterator>
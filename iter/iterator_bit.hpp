@@ -0,0 +1,155 @@
+#ifndef ITERATOR_BIT_HPP
+# define ITERATOR_BIT_HPP
+
+# include <climits>
+# include <cstddef>
+# include "iterator.hpp"
+
+namespace ft
+{
+	typedef unsigned long	bit_word;
+
+	enum { bit_word_size = sizeof(bit_word) * CHAR_BIT };
+
+	/* one bit of a packed vector<bool>: its word and the mask inside it */
+	class bit_reference
+	{
+	private:
+		bit_word*	_p;
+		bit_word	_mask;
+	public:
+		bit_reference(bit_word* p, bit_word mask): _p(p), _mask(mask) {}
+
+		operator bool() const { return (*_p & _mask) != 0; }
+		bool operator~() const { return (*_p & _mask) == 0; }
+
+		bit_reference& operator=(bool x)
+		{
+			if (x)
+				*_p |= _mask;
+			else
+				*_p &= ~_mask;
+			return *this;
+		}
+
+		bit_reference& operator=(const bit_reference& x) { return *this = bool(x); }
+
+		void flip() { *_p ^= _mask; }
+	};
+
+	/* word pointer + bit offset in [0, bit_word_size), shared by both iterators */
+	class bit_iterator_base
+	{
+	public:
+		typedef std::random_access_iterator_tag		iterator_category;
+		typedef bool								value_type;
+		typedef std::ptrdiff_t						difference_type;
+		typedef void								pointer;
+
+		bit_word*	_p;
+		unsigned	_offset;
+
+		bit_iterator_base(bit_word* p, unsigned offset): _p(p), _offset(offset) {}
+
+		void _incr()
+		{
+			if (_offset++ == bit_word_size - 1)
+			{
+				_offset = 0;
+				++_p;
+			}
+		}
+
+		void _decr()
+		{
+			if (_offset-- == 0)
+			{
+				_offset = bit_word_size - 1;
+				--_p;
+			}
+		}
+
+		void _incr(difference_type n)
+		{
+			difference_type i = n + _offset;
+			_p += i / bit_word_size;
+			i %= bit_word_size;
+			if (i < 0)
+			{
+				i += bit_word_size;
+				--_p;
+			}
+			_offset = static_cast<unsigned>(i);
+		}
+	};
+
+	inline std::ptrdiff_t operator-(const bit_iterator_base& x, const bit_iterator_base& y)
+	{
+		return bit_word_size * (x._p - y._p) + std::ptrdiff_t(x._offset) - std::ptrdiff_t(y._offset);
+	}
+
+	inline bool operator==(const bit_iterator_base& x, const bit_iterator_base& y)
+	{
+		return x._p == y._p && x._offset == y._offset;
+	}
+
+	inline bool operator!=(const bit_iterator_base& x, const bit_iterator_base& y) { return !(x == y); }
+
+	inline bool operator<(const bit_iterator_base& x, const bit_iterator_base& y)
+	{
+		return x._p < y._p || (x._p == y._p && x._offset < y._offset);
+	}
+
+	inline bool operator>(const bit_iterator_base& x, const bit_iterator_base& y) { return y < x; }
+	inline bool operator<=(const bit_iterator_base& x, const bit_iterator_base& y) { return !(y < x); }
+	inline bool operator>=(const bit_iterator_base& x, const bit_iterator_base& y) { return !(x < y); }
+
+	class bit_iterator: public bit_iterator_base
+	{
+	public:
+		typedef bit_reference	reference;
+
+		bit_iterator(): bit_iterator_base(0, 0) {}
+		bit_iterator(bit_word* p, unsigned offset): bit_iterator_base(p, offset) {}
+
+		reference operator*() const { return reference(_p, bit_word(1) << _offset); }
+		reference operator[](difference_type n) const { return *(*this + n); }
+
+		bit_iterator& operator++() { _incr(); return *this; }
+		bit_iterator& operator--() { _decr(); return *this; }
+		bit_iterator operator++(int) { bit_iterator tmp = *this; _incr(); return tmp; }
+		bit_iterator operator--(int) { bit_iterator tmp = *this; _decr(); return tmp; }
+		bit_iterator& operator+=(difference_type n) { _incr(n); return *this; }
+		bit_iterator& operator-=(difference_type n) { _incr(-n); return *this; }
+		bit_iterator operator+(difference_type n) const { bit_iterator tmp = *this; return tmp += n; }
+		bit_iterator operator-(difference_type n) const { bit_iterator tmp = *this; return tmp -= n; }
+	};
+
+	inline bit_iterator operator+(std::ptrdiff_t n, const bit_iterator& x) { return x + n; }
+
+	class bit_const_iterator: public bit_iterator_base
+	{
+	public:
+		typedef bool	reference;
+
+		bit_const_iterator(): bit_iterator_base(0, 0) {}
+		bit_const_iterator(const bit_word* p, unsigned offset): bit_iterator_base(const_cast<bit_word*>(p), offset) {}
+		bit_const_iterator(const bit_iterator& x): bit_iterator_base(x._p, x._offset) {}
+
+		reference operator*() const { return (*_p >> _offset) & 1; }
+		reference operator[](difference_type n) const { return *(*this + n); }
+
+		bit_const_iterator& operator++() { _incr(); return *this; }
+		bit_const_iterator& operator--() { _decr(); return *this; }
+		bit_const_iterator operator++(int) { bit_const_iterator tmp = *this; _incr(); return tmp; }
+		bit_const_iterator operator--(int) { bit_const_iterator tmp = *this; _decr(); return tmp; }
+		bit_const_iterator& operator+=(difference_type n) { _incr(n); return *this; }
+		bit_const_iterator& operator-=(difference_type n) { _incr(-n); return *this; }
+		bit_const_iterator operator+(difference_type n) const { bit_const_iterator tmp = *this; return tmp += n; }
+		bit_const_iterator operator-(difference_type n) const { bit_const_iterator tmp = *this; return tmp -= n; }
+	};
+
+	inline bit_const_iterator operator+(std::ptrdiff_t n, const bit_const_iterator& x) { return x + n; }
+}
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef ITERATOR_DEQUE_HPP
+# define ITERATOR_DEQUE_HPP
+
+# include "iterator.hpp"
+# include "../utils/utils.hpp"
+
+namespace ft
+{
+// elements per deque block: about one page of small elements, 16 of large ones
+	template<class T>
+	struct deque_block
+	{
+		enum { size = sizeof(T) < 256 ? 4096 / sizeof(T) : 16 };
+	};
+
+	/* position = block map + absolute index, block = pos / size, slot = pos % size */
+	template<class Value>
+	class deque_iterator
+	{
+	public:
+		typedef std::random_access_iterator_tag							iterator_category;
+		typedef typename ft::iterator_traits<Value*>::value_type		value_type;
+		typedef typename ft::iterator_traits<Value*>::reference			reference;
+		typedef typename ft::iterator_traits<Value*>::pointer			pointer;
+		typedef typename ft::iterator_traits<Value*>::difference_type	difference_type;
+
+		typedef typename ft::remove_const<value_type>::type				clear_value_type;
+		typedef clear_value_type**										map_pointer;
+
+		enum { block = deque_block<clear_value_type>::size };
+
+	private:
+		map_pointer		_map;
+		difference_type	_pos;
+
+	public:
+		deque_iterator(): _map(NULL), _pos(0) {}
+
+		deque_iterator(map_pointer map, difference_type pos): _map(map), _pos(pos) {}
+
+		deque_iterator(const deque_iterator<clear_value_type>& copy):
+			_map(copy.map()),
+			_pos(copy.pos())
+		{}
+
+		deque_iterator& operator=(const deque_iterator<clear_value_type>& copy)
+		{
+			_map = copy.map();
+			_pos = copy.pos();
+			return *this;
+		}
+
+		map_pointer map() const { return _map; }
+		difference_type pos() const { return _pos; }
+
+		reference operator*() const { return _map[_pos / block][_pos % block]; }
+		pointer operator->() const { return &(operator*()); }
+		reference operator[](difference_type n) const { return *(*this + n); }
+
+		deque_iterator& operator++() { ++_pos; return *this; }
+		deque_iterator& operator--() { --_pos; return *this; }
+
+		deque_iterator operator++(int)
+		{
+			deque_iterator tmp(*this);
+			++_pos;
+			return tmp;
+		}
+
+		deque_iterator operator--(int)
+		{
+			deque_iterator tmp(*this);
+			--_pos;
+			return tmp;
+		}
+
+		deque_iterator& operator+=(difference_type n) { _pos += n; return *this; }
+		deque_iterator& operator-=(difference_type n) { _pos -= n; return *this; }
+		deque_iterator operator+(difference_type n) const { return deque_iterator(_map, _pos + n); }
+		deque_iterator operator-(difference_type n) const { return deque_iterator(_map, _pos - n); }
+	};
+
+	template<typename A>
+	deque_iterator<A> operator+(typename deque_iterator<A>::difference_type n, const deque_iterator<A>& it)
+	{
+		return it + n;
+	}
+
+	template<typename A, typename B>
+	typename deque_iterator<A>::difference_type operator-(const deque_iterator<A>& lhs, const deque_iterator<B>& rhs)
+	{
+		return lhs.pos() - rhs.pos();
+	}
+
+	template<typename A, typename B>
+	bool operator==(const deque_iterator<A>& lhs, const deque_iterator<B>& rhs) { return lhs.pos() == rhs.pos(); }
+
+	template<typename A, typename B>
+	bool operator!=(const deque_iterator<A>& lhs, const deque_iterator<B>& rhs) { return lhs.pos() != rhs.pos(); }
+
+	template<typename A, typename B>
+	bool operator<(const deque_iterator<A>& lhs, const deque_iterator<B>& rhs) { return lhs.pos() < rhs.pos(); }
+
+	template<typename A, typename B>
+	bool operator>(const deque_iterator<A>& lhs, const deque_iterator<B>& rhs) { return lhs.pos() > rhs.pos(); }
+
+	template<typename A, typename B>
+	bool operator<=(const deque_iterator<A>& lhs, const deque_iterator<B>& rhs) { return lhs.pos() <= rhs.pos(); }
+
+	template<typename A, typename B>
+	bool operator>=(const deque_iterator<A>& lhs, const deque_iterator<B>& rhs) { return lhs.pos() >= rhs.pos(); }
+}
+
+#endif
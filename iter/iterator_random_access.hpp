@@ -143,6 +143,20 @@ namespace ft
 	{
 		return x.base() <= y.base();
 	}
+
+	template <typename Iterator1, typename Iterator2>
+	typename random_access_iterator<Iterator1>::difference_type
+	operator-(const random_access_iterator<Iterator1>& x, const random_access_iterator<Iterator2>& y)
+	{
+		return x.base() - y.base();
+	}
+
+	template <typename Iterator>
+	random_access_iterator<Iterator> operator+(typename random_access_iterator<Iterator>::difference_type n,
+												const random_access_iterator<Iterator>& x)
+	{
+		return x + n;
+	}
 }
 
 #endif
@@ -0,0 +1,199 @@
+#ifndef ITERATOR_STABLE_VECTOR_HPP
+# define ITERATOR_STABLE_VECTOR_HPP
+
+# include <cstddef>
+# include "iterator.hpp"
+# include "../utils/utils.hpp"
+
+namespace ft
+{
+/*
+* Chunk k of a stable_vector holds first << k elements, so chunks 0..k-1
+* hold first * (2^k - 1) together. Element i sits in the chunk given by
+* the highest bit of t = i + first, at t with that bit cleared.
+*/
+	struct stable_vector_chunks
+	{
+		enum { shift = 4, first = 1 << shift, max = sizeof(std::size_t) * 8 - shift };
+
+		static std::size_t size(std::size_t k) { return std::size_t(first) << k; }
+
+		/* elements in chunks [0, k) */
+		static std::size_t total(std::size_t k) { return (std::size_t(first) << k) - first; }
+
+		template<class T>
+		static T& at(T* const* chunks, std::size_t i)
+		{
+			std::size_t t = i + first;
+			int b = ft::floor_log2(t);
+			return chunks[b - shift][t - (std::size_t(1) << b)];
+		}
+	};
+
+	/*
+	* position = chunk table + index. The iterator also caches the element
+	* pointer and its chunk's end, filled on the first dereference: ++ and
+	* -- then move the pointer and drop the cache only when they cross a
+	* chunk boundary, a jump keeps it when it stays in the chunk.
+	*/
+	template<class Value>
+	class stable_vector_iterator
+	{
+	public:
+		typedef std::random_access_iterator_tag							iterator_category;
+		typedef typename ft::iterator_traits<Value*>::value_type		value_type;
+		typedef typename ft::iterator_traits<Value*>::reference			reference;
+		typedef typename ft::iterator_traits<Value*>::pointer			pointer;
+		typedef typename ft::iterator_traits<Value*>::difference_type	difference_type;
+
+		typedef typename ft::remove_const<value_type>::type				clear_value_type;
+		typedef clear_value_type* const*								chunk_pointer;
+
+	private:
+		chunk_pointer	_chunks;
+		difference_type	_pos;
+		mutable pointer	_cur;	/* NULL: not looked up yet */
+		mutable pointer	_end;	/* end of _cur's chunk */
+
+	public:
+		stable_vector_iterator(): _chunks(NULL), _pos(0), _cur(NULL), _end(NULL) {}
+
+		stable_vector_iterator(chunk_pointer chunks, difference_type pos):
+			_chunks(chunks),
+			_pos(pos),
+			_cur(NULL),
+			_end(NULL)
+		{}
+
+		stable_vector_iterator(const stable_vector_iterator<clear_value_type>& copy):
+			_chunks(copy.chunks()),
+			_pos(copy.pos()),
+			_cur(NULL),
+			_end(NULL)
+		{}
+
+		stable_vector_iterator& operator=(const stable_vector_iterator<clear_value_type>& copy)
+		{
+			_chunks = copy.chunks();
+			_pos = copy.pos();
+			_cur = NULL;
+			return *this;
+		}
+
+		chunk_pointer chunks() const { return _chunks; }
+		difference_type pos() const { return _pos; }
+
+		reference operator*() const
+		{
+			if (_cur == NULL)
+				_seek();
+			return *_cur;
+		}
+
+		pointer operator->() const { return &(operator*()); }
+		reference operator[](difference_type n) const { return *(*this + n); }
+
+		stable_vector_iterator& operator++()
+		{
+			++_pos;
+			if (_cur != NULL && ++_cur == _end)
+				_cur = NULL;
+			return *this;
+		}
+
+		/* _pos + first is a power of two at the first slot of a chunk */
+		stable_vector_iterator& operator--()
+		{
+			std::size_t t = std::size_t(_pos) + stable_vector_chunks::first;
+			--_pos;
+			if (_cur != NULL)
+			{
+				if ((t & (t - 1)) == 0)
+					_cur = NULL;
+				else
+					--_cur;
+			}
+			return *this;
+		}
+
+		stable_vector_iterator operator++(int)
+		{
+			stable_vector_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		stable_vector_iterator operator--(int)
+		{
+			stable_vector_iterator tmp(*this);
+			--*this;
+			return tmp;
+		}
+
+		stable_vector_iterator& operator+=(difference_type n)
+		{
+			_pos += n;
+			if (_cur != NULL && n >= 0 && n < _end - _cur)
+				_cur += n;
+			else
+				_cur = NULL;
+			return *this;
+		}
+
+		stable_vector_iterator& operator-=(difference_type n) { return *this += -n; }
+
+		stable_vector_iterator operator+(difference_type n) const
+		{
+			stable_vector_iterator tmp(*this);
+			return tmp += n;
+		}
+
+		stable_vector_iterator operator-(difference_type n) const
+		{
+			stable_vector_iterator tmp(*this);
+			return tmp += -n;
+		}
+
+	private:
+		void _seek() const
+		{
+			std::size_t t = std::size_t(_pos) + stable_vector_chunks::first;
+			int b = ft::floor_log2(t);
+			clear_value_type* chunk = _chunks[b - stable_vector_chunks::shift];
+			_cur = chunk + (t - (std::size_t(1) << b));
+			_end = chunk + (std::size_t(1) << b);
+		}
+	};
+
+	template<typename A>
+	stable_vector_iterator<A> operator+(typename stable_vector_iterator<A>::difference_type n, const stable_vector_iterator<A>& it)
+	{
+		return it + n;
+	}
+
+	template<typename A, typename B>
+	typename stable_vector_iterator<A>::difference_type operator-(const stable_vector_iterator<A>& lhs, const stable_vector_iterator<B>& rhs)
+	{
+		return lhs.pos() - rhs.pos();
+	}
+
+	template<typename A, typename B>
+	bool operator==(const stable_vector_iterator<A>& lhs, const stable_vector_iterator<B>& rhs) { return lhs.pos() == rhs.pos(); }
+
+	template<typename A, typename B>
+	bool operator!=(const stable_vector_iterator<A>& lhs, const stable_vector_iterator<B>& rhs) { return lhs.pos() != rhs.pos(); }
+
+	template<typename A, typename B>
+	bool operator<(const stable_vector_iterator<A>& lhs, const stable_vector_iterator<B>& rhs) { return lhs.pos() < rhs.pos(); }
+
+	template<typename A, typename B>
+	bool operator>(const stable_vector_iterator<A>& lhs, const stable_vector_iterator<B>& rhs) { return lhs.pos() > rhs.pos(); }
+
+	template<typename A, typename B>
+	bool operator<=(const stable_vector_iterator<A>& lhs, const stable_vector_iterator<B>& rhs) { return lhs.pos() <= rhs.pos(); }
+
+	template<typename A, typename B>
+	bool operator>=(const stable_vector_iterator<A>& lhs, const stable_vector_iterator<B>& rhs) { return lhs.pos() >= rhs.pos(); }
+}
+
+#endif
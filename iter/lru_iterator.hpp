@@ -0,0 +1,98 @@
+#ifndef LRU_ITERATOR_HPP
+# define LRU_ITERATOR_HPP
+
+# include "../utils/utils.hpp"
+
+namespace ft
+{
+	/* the recency list, circular through the cache's head: _next is less recent */
+	struct lru_link
+	{
+		lru_link*	_prev;
+		lru_link*	_next;
+	};
+
+	/* _hook belongs to the index: the next node of a hash chain, or the node's RBTree node */
+	template<class Value>
+	struct lru_node: public lru_link
+	{
+		Value	_value;
+		void*	_hook;
+	};
+
+	/* most recently used first */
+	template<class Value>
+	class lru_iterator
+	{
+	public:
+		typedef std::bidirectional_iterator_tag							iterator_category;
+		typedef typename ft::iterator_traits<Value*>::value_type		value_type;
+		typedef typename ft::iterator_traits<Value*>::reference			reference;
+		typedef typename ft::iterator_traits<Value*>::pointer			pointer;
+		typedef typename ft::iterator_traits<Value*>::difference_type	difference_type;
+
+		typedef typename ft::remove_const<value_type>::type				clear_value_type;
+		typedef lru_node<clear_value_type>								node_type;
+
+	private:
+		lru_link*	_link;
+
+	public:
+		lru_iterator(): _link(NULL) {}
+
+		explicit lru_iterator(lru_link* link): _link(link) {}
+
+		lru_iterator(const lru_iterator<clear_value_type>& copy): _link(copy.link()) {}
+
+		lru_iterator& operator=(const lru_iterator<clear_value_type>& copy)
+		{
+			_link = copy.link();
+			return *this;
+		}
+
+		lru_link* link() const { return _link; }
+
+		reference operator*() const { return static_cast<node_type*>(_link)->_value; }
+		pointer operator->() const { return &static_cast<node_type*>(_link)->_value; }
+
+		lru_iterator& operator++()
+		{
+			_link = _link->_next;
+			return *this;
+		}
+
+		lru_iterator operator++(int)
+		{
+			lru_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		lru_iterator& operator--()
+		{
+			_link = _link->_prev;
+			return *this;
+		}
+
+		lru_iterator operator--(int)
+		{
+			lru_iterator tmp(*this);
+			--*this;
+			return tmp;
+		}
+	};
+
+	template<typename A, typename B>
+	bool operator==(const lru_iterator<A>& lhs, const lru_iterator<B>& rhs)
+	{
+		return lhs.link() == rhs.link();
+	}
+
+	template<typename A, typename B>
+	bool operator!=(const lru_iterator<A>& lhs, const lru_iterator<B>& rhs)
+	{
+		return lhs.link() != rhs.link();
+	}
+}
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef RADIX_ITERATOR_HPP
+# define RADIX_ITERATOR_HPP
+
+# include "../tree/radix_node.hpp"
+# include "../utils/utils.hpp"
+
+namespace ft
+{
+	/* walks the radix_map leaf list: one pointer load per step */
+	template<class Value>
+	class radix_iterator
+	{
+	public:
+		typedef std::bidirectional_iterator_tag							iterator_category;
+		typedef typename ft::iterator_traits<Value*>::value_type		value_type;
+		typedef typename ft::iterator_traits<Value*>::reference			reference;
+		typedef typename ft::iterator_traits<Value*>::pointer			pointer;
+		typedef typename ft::iterator_traits<Value*>::difference_type	difference_type;
+
+		typedef typename ft::remove_const<value_type>::type				clear_value_type;
+		typedef radix_leaf_node<clear_value_type>						leaf_type;
+
+	private:
+		radix_link*	_link;
+
+	public:
+		radix_iterator(): _link(NULL) {}
+
+		explicit radix_iterator(radix_link* link): _link(link) {}
+
+		radix_iterator(const radix_iterator<clear_value_type>& copy): _link(copy.link()) {}
+
+		radix_iterator& operator=(const radix_iterator<clear_value_type>& copy)
+		{
+			_link = copy.link();
+			return *this;
+		}
+
+		radix_link* link() const { return _link; }
+
+		reference operator*() const { return static_cast<leaf_type*>(_link)->_value; }
+		pointer operator->() const { return &static_cast<leaf_type*>(_link)->_value; }
+
+		radix_iterator& operator++()
+		{
+			_link = _link->_next;
+			FT_PREFETCH(_link->_next);
+			return *this;
+		}
+
+		radix_iterator operator++(int)
+		{
+			radix_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		radix_iterator& operator--()
+		{
+			_link = _link->_prev;
+			return *this;
+		}
+
+		radix_iterator operator--(int)
+		{
+			radix_iterator tmp(*this);
+			--*this;
+			return tmp;
+		}
+	};
+
+	template<typename A, typename B>
+	bool operator==(const radix_iterator<A>& lhs, const radix_iterator<B>& rhs)
+	{
+		return lhs.link() == rhs.link();
+	}
+
+	template<typename A, typename B>
+	bool operator!=(const radix_iterator<A>& lhs, const radix_iterator<B>& rhs)
+	{
+		return lhs.link() != rhs.link();
+	}
+}
+
+#endif
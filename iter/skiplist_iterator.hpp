@@ -0,0 +1,71 @@
+#ifndef SKIPLIST_ITERATOR_HPP
+# define SKIPLIST_ITERATOR_HPP
+
+# include "../tree/skiplist_node.hpp"
+# include "../utils/utils.hpp"
+
+namespace ft
+{
+	/* forward along level 0 of a skiplist_map, stepping over deleted nodes */
+	template<class Value>
+	class skiplist_iterator
+	{
+	public:
+		typedef std::forward_iterator_tag								iterator_category;
+		typedef typename ft::iterator_traits<Value*>::value_type		value_type;
+		typedef typename ft::iterator_traits<Value*>::reference			reference;
+		typedef typename ft::iterator_traits<Value*>::pointer			pointer;
+		typedef typename ft::iterator_traits<Value*>::difference_type	difference_type;
+
+		typedef typename ft::remove_const<value_type>::type				clear_value_type;
+		typedef skiplist_node<clear_value_type>							node_type;
+
+	private:
+		node_type*	_node;
+
+	public:
+		skiplist_iterator(): _node(NULL) {}
+
+		explicit skiplist_iterator(node_type* node): _node(node) {}
+
+		skiplist_iterator(const skiplist_iterator<clear_value_type>& copy): _node(copy.node()) {}
+
+		skiplist_iterator& operator=(const skiplist_iterator<clear_value_type>& copy)
+		{
+			_node = copy.node();
+			return *this;
+		}
+
+		node_type* node() const { return _node; }
+
+		reference operator*() const { return _node->_value; }
+		pointer operator->() const { return &_node->_value; }
+
+		skiplist_iterator& operator++()
+		{
+			_node = _node->next_live();
+			return *this;
+		}
+
+		skiplist_iterator operator++(int)
+		{
+			skiplist_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+	};
+
+	template<typename A, typename B>
+	bool operator==(const skiplist_iterator<A>& lhs, const skiplist_iterator<B>& rhs)
+	{
+		return lhs.node() == rhs.node();
+	}
+
+	template<typename A, typename B>
+	bool operator!=(const skiplist_iterator<A>& lhs, const skiplist_iterator<B>& rhs)
+	{
+		return lhs.node() != rhs.node();
+	}
+}
+
+#endif
@@ -0,0 +1,472 @@
+#ifndef LRU_CACHE_HPP
+# define LRU_CACHE_HPP
+
+# include <memory>
+# include <functional>
+# include <stdexcept>
+# include "./iter/lru_iterator.hpp"
+# include "./tree/RBTree.hpp"
+# include "./utils/hash.hpp"
+# include "./utils/utils.hpp"
+
+namespace ft
+{
+/*
+* Index policies for lru_cache. bind<Node, Allocator>::type is built once
+* with the capacity and maps a key to the lru_node holding it through the
+* node's _hook: find(key), insert(node) of a node whose key is absent,
+* erase(node) of an indexed node, dispose(node) of each free slot when
+* the cache dies, and memory_usage(). Neither allocates after
+* construction, or after the first use of each slot.
+*/
+
+	template <class Key, class Hash = ft::hash<Key>, class Equal = std::equal_to<Key> >
+	struct lru_hash_index;
+
+	template <class Key, class Compare = std::less<Key> >
+	struct lru_tree_index;
+
+	/* chained hash table, one bucket per slot rounded up to a power of two, chains through _hook */
+	template <class Key, class Node, class Hash, class Equal, class Allocator>
+	class lru_hash_table
+	{
+	private:
+		typedef typename	Allocator::template rebind<Node*>::other	bucket_allocator;
+
+		bucket_allocator	_alloc;
+		Hash				_hash;
+		Equal				_equal;
+		Node**				_buckets;
+		std::size_t			_mask;
+
+		lru_hash_table(const lru_hash_table&);
+		lru_hash_table& operator=(const lru_hash_table&);
+
+		static Node*& _chain(Node* x) { return reinterpret_cast<Node*&>(x->_hook); }
+
+		Node** _bucket(const Key& k) const { return _buckets + (_hash(k) & _mask); }
+
+	public:
+		lru_hash_table(std::size_t capacity, const lru_hash_index<Key, Hash, Equal>& policy, const Allocator& alloc):
+			_alloc(alloc), _hash(policy.hash), _equal(policy.equal), _buckets(NULL), _mask(0)
+		{
+			std::size_t n = 2;
+			while (n < capacity)
+				n <<= 1;
+			_buckets = _alloc.allocate(n);
+			_mask = n - 1;
+			for (std::size_t i = 0; i < n; ++i)
+				_buckets[i] = NULL;
+		}
+
+		~lru_hash_table()
+		{
+			_alloc.deallocate(_buckets, _mask + 1);
+		}
+
+		Node* find(const Key& k) const
+		{
+			Node* x = *_bucket(k);
+			while (x != NULL && !_equal(x->_value.first, k))
+				x = _chain(x);
+			return x;
+		}
+
+		void insert(Node* x)
+		{
+			Node** b = _bucket(x->_value.first);
+			_chain(x) = *b;
+			*b = x;
+		}
+
+		void erase(Node* x)
+		{
+			Node** p = _bucket(x->_value.first);
+			while (*p != x)
+				p = &_chain(*p);
+			*p = _chain(x);
+		}
+
+		void dispose(Node*) {}
+
+		std::size_t memory_usage() const { return (_mask + 1) * sizeof(Node*); }
+	};
+
+	template <class Key, class Hash, class Equal>
+	struct lru_hash_index
+	{
+		Hash	hash;
+		Equal	equal;
+
+		explicit lru_hash_index(const Hash& h = Hash(), const Equal& e = Equal()): hash(h), equal(e) {}
+
+		template <class Node, class Allocator>
+		struct bind
+		{
+			typedef lru_hash_table<Key, Node, Hash, Equal, Allocator> type;
+		};
+	};
+
+/*
+* RBTree of (key, node) entries, one tree node per slot in use so far. The
+* key is copied next to the links so a descent touches no lru_node. A
+* slot keeps its tree node for good: erase extracts it into the slot's
+* _hook and the next insert of that slot links it back as a node handle.
+*/
+	template <class Key, class Node>
+	struct lru_tree_entry
+	{
+		Key		_key;
+		Node*	_node;
+
+		lru_tree_entry(const Key& key, Node* node): _key(key), _node(node) {}
+	};
+
+	template <class Key, class Node, class Compare, class Allocator>
+	class lru_tree
+	{
+	private:
+		typedef				lru_tree_entry<Key, Node>						entry;
+
+		struct entry_compare
+		{
+			Compare	_comp;
+
+			explicit entry_compare(const Compare& comp): _comp(comp) {}
+
+			bool operator()(const entry& a, const entry& b) const { return _comp(a._key, b._key); }
+		};
+
+		typedef typename	Allocator::template rebind<entry>::other		entry_allocator;
+		typedef				RBTree<entry, entry_compare, entry_allocator>	tree_type;
+		typedef typename	tree_type::node_pointer							node_pointer;
+		typedef typename	tree_type::node_type							node_handle;
+
+		Compare		_comp;
+		tree_type	_tree;
+		std::size_t	_nodes;		/* tree nodes made so far, linked or parked in a hook */
+
+		lru_tree(const lru_tree&);
+		lru_tree& operator=(const lru_tree&);
+
+	public:
+		lru_tree(std::size_t, const lru_tree_index<Key, Compare>& policy, const Allocator& alloc):
+			_comp(policy.comp), _tree(entry_compare(policy.comp), entry_allocator(alloc)), _nodes(0)
+		{}
+
+		/* one comparison per level, like RBTree::_search */
+		Node* find(const Key& k) const
+		{
+			node_pointer node = _tree._root;
+			node_pointer candidate = _tree._nil;
+			while (node != _tree._nil)
+			{
+				if (_comp(k, node->_value._key))
+					node = node->_left;
+				else
+				{
+					candidate = node;
+					node = node->_right;
+				}
+			}
+			if (candidate == _tree._nil || _comp(candidate->_value._key, k))
+				return NULL;
+			return candidate->_value._node;
+		}
+
+		void insert(Node* x)
+		{
+			if (x->_hook == NULL)
+			{
+				x->_hook = _tree.insert(entry(x->_value.first, x)).first;
+				++_nodes;
+				return ;
+			}
+			node_pointer parked = static_cast<node_pointer>(x->_hook);
+			parked->_value._key = x->_value.first;
+			node_handle nh(parked, _tree._alloc_value);
+			_tree.insert(nh);
+		}
+
+		void erase(Node* x)
+		{
+			x->_hook = _tree.extract(typename tree_type::iterator(x->_hook)).release();
+		}
+
+		/* x is a free slot of the dying cache: the handle frees its parked node */
+		void dispose(Node* x)
+		{
+			if (x->_hook != NULL)
+				node_handle parked(static_cast<node_pointer>(x->_hook), _tree._alloc_value);
+		}
+
+		std::size_t memory_usage() const { return (_nodes + 1) * sizeof(typename tree_type::Node); }
+	};
+
+	template <class Key, class Compare>
+	struct lru_tree_index
+	{
+		Compare	comp;
+
+		explicit lru_tree_index(const Compare& c = Compare()): comp(c) {}
+
+		template <class Node, class Allocator>
+		struct bind
+		{
+			typedef lru_tree<Key, Node, Compare, Allocator> type;
+		};
+	};
+
+	/* counted by get() and operator[] and by put() when it has to make room */
+	struct lru_stats
+	{
+		unsigned long	hits;
+		unsigned long	misses;
+		unsigned long	evictions;
+	};
+
+/*
+* Bounded map that evicts the least recently used entry. Every entry is
+* one lru_node from an array allocated with the cache: key and value,
+* the recency links and the index hook, so a hit is one index lookup
+* and two relinks, and an eviction reuses the slot in place. Iteration
+* goes from the most to the least recently used entry. Not thread safe,
+* not even find-only: get() reorders the list.
+*/
+	template <class Key,
+				class T,
+				class Index = lru_hash_index<Key>,
+				class Allocator = std::allocator<ft::pair<const Key, T> > >
+	class lru_cache
+	{
+	public:
+		typedef				Key										key_type;
+		typedef				T										mapped_type;
+		typedef				ft::pair<const Key, T>					value_type;
+		typedef				Index									index_policy;
+		typedef				Allocator								allocator_type;
+		typedef typename	Allocator::reference					reference;
+		typedef typename	Allocator::const_reference				const_reference;
+		typedef typename	Allocator::pointer						pointer;
+		typedef typename	Allocator::const_pointer				const_pointer;
+		typedef typename	Allocator::size_type					size_type;
+		typedef typename	Allocator::difference_type				difference_type;
+
+		typedef				lru_iterator<value_type>				iterator;
+		typedef				lru_iterator<const value_type>			const_iterator;
+
+	private:
+		typedef				lru_node<value_type>									node_type;
+		typedef typename	Allocator::template rebind<node_type>::other			node_allocator;
+		typedef typename	Index::template bind<node_type, Allocator>::type		index_type;
+
+		allocator_type	_alloc;
+		size_type		_capacity;
+		size_type		_size;
+		lru_link		_head;		/* _next is the most, _prev the least recently used */
+		lru_link*		_free;		/* unused slots, through _next */
+		node_type*		_nodes;
+		index_type		_index;
+		lru_stats		_stats;
+
+		lru_cache(const lru_cache&);
+		lru_cache& operator=(const lru_cache&);
+
+	public:
+// construct/destroy:
+		explicit lru_cache(size_type capacity, const Index& index = Index(), const allocator_type& alloc = allocator_type()):
+			_alloc(alloc),
+			_capacity(_check_capacity(capacity, alloc)),
+			_size(0),
+			_free(NULL),
+			_nodes(NULL),
+			_index(capacity, index, alloc)
+		{
+			_head._prev = &_head;
+			_head._next = &_head;
+			_nodes = node_allocator(_alloc).allocate(capacity);
+			for (size_type i = capacity; i-- > 0; )
+			{
+				_nodes[i]._hook = NULL;
+				_nodes[i]._next = _free;
+				_free = &_nodes[i];
+			}
+			reset_stats();
+		}
+
+		~lru_cache()
+		{
+			for (lru_link* l = _head._next; l != &_head; l = l->_next)
+				_alloc.destroy(&static_cast<node_type*>(l)->_value);
+			for (lru_link* l = _free; l != NULL; l = l->_next)
+				_index.dispose(static_cast<node_type*>(l));
+			node_allocator(_alloc).deallocate(_nodes, _capacity);
+		}
+
+		allocator_type get_allocator() const { return _alloc; }
+
+// iterators:
+		iterator begin() { return iterator(_head._next); }
+		const_iterator begin() const { return const_iterator(_head._next); }
+		iterator end() { return iterator(&_head); }
+		const_iterator end() const { return const_iterator(const_cast<lru_link*>(&_head)); }
+
+// capacity:
+		bool empty() const { return _size == 0; }
+		bool full() const { return _size == _capacity; }
+		size_type size() const { return _size; }
+		size_type capacity() const { return _capacity; }
+		/* heap bytes held: the node array and the index */
+		size_type memory_usage() const { return _capacity * sizeof(node_type) + _index.memory_usage(); }
+
+// lookup:
+		/* the value, made most recently used, or NULL; counts a hit or a miss */
+		mapped_type* get(const key_type& k)
+		{
+			node_type* x = _index.find(k);
+			if (x == NULL)
+			{
+				++_stats.misses;
+				return NULL;
+			}
+			++_stats.hits;
+			_touch(x);
+			return &x->_value.second;
+		}
+
+		/* neither reorders nor counts */
+		const mapped_type* peek(const key_type& k) const
+		{
+			node_type* x = _index.find(k);
+			return x == NULL ? NULL : &x->_value.second;
+		}
+
+		bool contains(const key_type& k) const { return _index.find(k) != NULL; }
+
+		/* inserts T() on a miss, which may evict */
+		mapped_type& operator[](const key_type& k)
+		{
+			mapped_type* v = get(k);
+			if (v != NULL)
+				return *v;
+			return _insert(value_type(k, mapped_type()))->_value.second;
+		}
+
+// modifiers:
+		/*
+		* Assigns and touches an existing key, otherwise takes a free slot or
+		* evicts the least recently used entry. If T's copy throws, an
+		* eviction made for it stays done.
+		*/
+		ft::pair<iterator, bool> put(const value_type& value)
+		{
+			node_type* x = _index.find(value.first);
+			if (x != NULL)
+			{
+				x->_value.second = value.second;
+				_touch(x);
+				return ft::pair<iterator, bool>(iterator(x), false);
+			}
+			return ft::pair<iterator, bool>(iterator(_insert(value)), true);
+		}
+
+		ft::pair<iterator, bool> put(const key_type& k, const mapped_type& v) { return put(value_type(k, v)); }
+
+		size_type erase(const key_type& k)
+		{
+			node_type* x = _index.find(k);
+			if (x == NULL)
+				return 0;
+			_release(x);
+			return 1;
+		}
+
+		void erase(iterator position)
+		{
+			_release(static_cast<node_type*>(position.link()));
+		}
+
+		void clear()
+		{
+			while (_head._next != &_head)
+				_release(static_cast<node_type*>(_head._next));
+		}
+
+// stats:
+		lru_stats stats() const { return _stats; }
+
+		void reset_stats()
+		{
+			_stats.hits = 0;
+			_stats.misses = 0;
+			_stats.evictions = 0;
+		}
+
+	private:
+		static size_type _check_capacity(size_type capacity, const allocator_type& alloc)
+		{
+			if (capacity == 0 || capacity > node_allocator(alloc).max_size())
+				throw std::length_error("lru_cache");
+			return capacity;
+		}
+
+		static void _unlink(lru_link* x)
+		{
+			x->_prev->_next = x->_next;
+			x->_next->_prev = x->_prev;
+		}
+
+		void _push_front(lru_link* x)
+		{
+			x->_prev = &_head;
+			x->_next = _head._next;
+			_head._next->_prev = x;
+			_head._next = x;
+		}
+
+		void _touch(node_type* x)
+		{
+			if (_head._next == x)
+				return ;
+			_unlink(x);
+			_push_front(x);
+		}
+
+		/* k is not in the cache */
+		node_type* _insert(const value_type& value)
+		{
+			if (_free == NULL)
+			{
+				_release(static_cast<node_type*>(_head._prev));
+				++_stats.evictions;
+			}
+			node_type* x = static_cast<node_type*>(_free);
+			_alloc.construct(&x->_value, value);
+			try
+			{
+				_index.insert(x);
+			}
+			catch (...)
+			{
+				_alloc.destroy(&x->_value);
+				throw ;
+			}
+			_free = x->_next;
+			_push_front(x);
+			++_size;
+			return x;
+		}
+
+		void _release(node_type* x)
+		{
+			_index.erase(x);
+			_unlink(x);
+			_alloc.destroy(&x->_value);
+			x->_next = _free;
+			_free = x;
+			--_size;
+		}
+	};
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <string>
 #include <deque>
+#include <map>
 
 #if 0
 	# include <map>
@@ -11,6 +12,10 @@
 	# include "map.hpp"
 	# include "stack.hpp"
 	# include "vector.hpp"
+	# include "radix_map.hpp"
+	# include "skiplist_map.hpp"
+	# include <pthread.h>
+	# define FT_ONLY_CHECKS
 #endif
 
 #include <stdlib.h>
@@ -50,6 +55,123 @@ public:
 	iterator end() { return this->c.end(); }
 };
 
+#ifdef FT_ONLY_CHECKS
+std::string randomKey()
+{
+	std::string key;
+	for (int len = 1 + rand() % 5; len; --len)
+		key += "abcd"[rand() % 4];
+	return key;
+}
+
+void checkRadixMap()
+{
+	ft::radix_map<std::string, int> radix;
+	std::map<std::string, int> ref;
+
+	for (int i = 0; i<20000; ++i) {
+		const std::string key = randomKey();
+		if (rand() % 3) {
+			if (radix.insert(ft::make_pair(key, i)).second != ref.insert(std::make_pair(key, i)).second)
+				throw ("radix_map insert should match std::map");
+		}
+		else if (radix.erase(key) != ref.erase(key))
+			throw ("radix_map erase should match std::map");
+	}
+	if (radix.size() != ref.size())
+		throw ("radix_map size should match std::map");
+	std::map<std::string, int>::iterator rit = ref.begin();
+	for (ft::radix_map<std::string, int>::iterator it = radix.begin(); it!=radix.end(); ++it, ++rit)
+		if (it->first != rit->first || it->second != rit->second)
+			throw ("radix_map should iterate in std::map order");
+
+	for (int i = 0; i<2000; ++i) {
+		const std::string key = randomKey();
+		ft::radix_map<std::string, int>::iterator lower = radix.lower_bound(key);
+		rit = ref.lower_bound(key);
+		if ((lower == radix.end()) != (rit == ref.end()) || (rit != ref.end() && lower->first != rit->first))
+			throw ("radix_map lower_bound should match std::map");
+
+		const std::string prefix = key.substr(0, 1 + rand() % key.size());
+		ft::pair<ft::radix_map<std::string, int>::iterator, ft::radix_map<std::string, int>::iterator> range = radix.prefix_range(prefix);
+		for (rit = ref.lower_bound(prefix); rit != ref.end() && rit->first.compare(0, prefix.size(), prefix) == 0; ++rit, ++range.first)
+			if (range.first == range.second || range.first->first != rit->first)
+				throw ("radix_map prefix_range should hold every key starting with the prefix");
+		if (range.first != range.second)
+			throw ("radix_map prefix_range should end after the prefix");
+	}
+	std::cout << "radix_map size: " << radix.size() << std::endl;
+}
+
+#define SKIPLIST_THREADS 4
+#define SKIPLIST_KEYS 20000
+
+struct SkiplistTask {
+	ft::skiplist_map<int, int>* map;
+	int thread;
+	bool failed;
+};
+
+/* each thread inserts, finds and erases its own keys (key % threads), and reads everyone's */
+void* skiplistWorker(void* arg)
+{
+	SkiplistTask* task = static_cast<SkiplistTask*>(arg);
+	ft::skiplist_map<int, int>& map = *task->map;
+
+	for (int k = task->thread; k<SKIPLIST_KEYS; k += SKIPLIST_THREADS)
+		if (!map.insert(ft::make_pair(k, -k)).second)
+			task->failed = true;
+	for (int k = task->thread; k<SKIPLIST_KEYS; k += SKIPLIST_THREADS) {
+		ft::skiplist_map<int, int>::read_guard guard(map);
+		ft::skiplist_map<int, int>::iterator it = map.find(k);
+		if (it == map.end() || it->second != -k)
+			task->failed = true;
+		map.count(k + 1);
+	}
+	for (int k = task->thread; k<SKIPLIST_KEYS; k += 2 * SKIPLIST_THREADS)
+		if (map.erase(k) != 1)
+			task->failed = true;
+	return NULL;
+}
+
+void checkSkiplistMap()
+{
+	ft::skiplist_map<int, int> map;
+	pthread_t threads[SKIPLIST_THREADS];
+	SkiplistTask tasks[SKIPLIST_THREADS];
+
+	for (int t = 0; t<SKIPLIST_THREADS; ++t) {
+		tasks[t].map = &map;
+		tasks[t].thread = t;
+		tasks[t].failed = false;
+		if (pthread_create(&threads[t], NULL, skiplistWorker, &tasks[t]))
+			throw ("pthread_create failed");
+	}
+	for (int t = 0; t<SKIPLIST_THREADS; ++t) {
+		pthread_join(threads[t], NULL);
+		if (tasks[t].failed)
+			throw ("skiplist_map insert/find/erase failed under threads");
+	}
+
+	int expected = 0;
+	for (int k = 0; k<SKIPLIST_KEYS; ++k) {
+		const bool erased = (k % (2 * SKIPLIST_THREADS)) < SKIPLIST_THREADS;
+		if (map.count(k) != (erased ? 0u : 1u))
+			throw ("skiplist_map should hold exactly the keys left by the threads");
+		expected += !erased;
+	}
+	if (map.size() != (unsigned)expected)
+		throw ("skiplist_map size should match the keys left");
+	int prev = -1;
+	for (ft::skiplist_map<int, int>::iterator it = map.begin(); it!=map.end(); ++it) {
+		if (it->first <= prev)
+			throw ("skiplist_map should iterate in order");
+		prev = it->first;
+	}
+	std::cout << "skiplist_map size: " << map.size() << std::endl;
+}
+#endif
+
 int main(int argc, char** argv)
 {
 	if (argc != 2)
@@ -260,5 +382,13 @@ int main(int argc, char** argv)
 	std::cout << "equal range lower: " << res1->first << " " << res1->second << std::endl;
 	std::cout << "equal range upper: " << res2->first << " " << res2->second << std::endl;
 
+#ifdef FT_ONLY_CHECKS
+	std::cout << "Checking radix_map" << std::endl << std::endl;
+	checkRadixMap();
+
+	std::cout << "Checking skiplist_map" << std::endl << std::endl;
+	checkSkiplistMap();
+#endif
+
 	return (0);
 }
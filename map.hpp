@@ -2,11 +2,40 @@
 # define MAP_HPP
 
 # include <memory>
+# include <algorithm>
 # include "./tree/RBTree.hpp"
 # include "./utils/utils.hpp"
 
 namespace ft {
 
+	template <class Key, class T, class Compare, class Allocator>
+	class map;
+
+	/* map::value_compare: orders values by key */
+	template <class Key, class T, class Compare>
+	class map_value_compare
+		: public std::binary_function<ft::pair<const Key, T>, ft::pair<const Key, T>, bool> {
+	template <class, class, class, class> friend class map;
+	protected:
+		Compare comp;
+		map_value_compare(Compare c) : comp(c) {}
+	public:
+		bool operator()(const ft::pair<const Key, T>& x, const ft::pair<const Key, T>& y) const {
+			return comp(x.first, y.first);
+		}
+	};
+
+	/* the RBTree descents see key_compare's prefix through the value */
+	template <class Key, class T, class Compare>
+	struct compare_prefix<map_value_compare<Key, T, Compare> >
+	{
+		enum { enabled = compare_prefix<Compare>::enabled };
+
+		typedef typename compare_prefix<Compare>::type	type;
+
+		static type get(const ft::pair<const Key, T>& x) { return compare_prefix<Compare>::get(x.first); }
+	};
+
 	template <class Key,
 				class T,
 				class Compare = std::less<Key>,
@@ -26,23 +55,14 @@ namespace ft {
 		typedef typename 	Allocator::pointer			pointer;
 		typedef typename 	Allocator::const_pointer	const_pointer;
 
-		class value_compare
-			: public std::binary_function<value_type,value_type,bool> {
-		friend class map;
-		protected:
-			Compare comp;
-			value_compare(Compare c) : comp(c) {}
-		public:
-			bool operator()(const value_type& x, const value_type& y) const {
-				return comp(x.first, y.first);
-			}
-		};
+		typedef				map_value_compare<Key, T, Compare>	value_compare;
 
 		typedef RBTree<value_type, value_compare, allocator_type>	tree_type;
 		typedef typename tree_type::iterator						iterator;
 		typedef typename tree_type::const_iterator					const_iterator;
 		typedef typename tree_type::reverse_iterator				reverse_iterator;
 		typedef typename tree_type::const_reverse_iterator			const_reverse_iterator;
+		typedef typename tree_type::node_type						node_type;
 	
 	public:
 		allocator_type	_alloc;
@@ -88,6 +108,8 @@ namespace ft {
 		~map()
 		{}
 
+		allocator_type get_allocator() const { return _alloc; }
+
 // iterators:
 		iterator begin() { return _tree.begin(); }
 		const_iterator begin() const { return _tree.begin(); }
@@ -102,6 +124,10 @@ namespace ft {
 		bool empty() const { return _tree.empty(); }
 		size_type size() const { return _tree.size(); }
 		size_type max_size() const { return _tree.max_size(); }
+		size_type memory_usage() const { return _tree.memory_usage(); }
+		/* comparator calls, rotations, recolorings (-DFT_RBTREE_TELEMETRY) and depths */
+		rbtree_telemetry telemetry() const { return _tree.telemetry(); }
+		void reset_telemetry() { _tree.reset_telemetry(); }
 
 // 23.3.1.2 element access
 		T& operator[](const key_type& x)
@@ -147,6 +173,50 @@ namespace ft {
 		void swap(map & other)
 		{
 			_tree.swap(other._tree);
+			std::swap(_alloc, other._alloc);
+			std::swap(_comp, other._comp);
+		}
+
+// C++17 node handles: relink nodes between containers, no allocation, no copy
+		node_type extract(iterator position)
+		{
+			return _tree.extract(position);
+		}
+
+		node_type extract(const key_type& x)
+		{
+			return _tree.extract(ft::make_pair(x, mapped_type()));
+		}
+
+		pair<iterator, bool> insert(node_type& nh)
+		{
+			return _tree.insert(nh);
+		}
+
+		void merge(map& source)
+		{
+			_tree.merge(source._tree);
+		}
+
+		/* O(n) bulk load, [first, last) must be sorted by key and duplicate-free */
+		template <class RandomIt>
+		void assign_sorted(RandomIt first, RandomIt last)
+		{
+			_tree.assign_sorted(first, last);
+		}
+
+		/* same, built on `threads` threads (thread-safe allocator required) */
+		template <class RandomIt>
+		void assign_sorted(RandomIt first, RandomIt last, unsigned threads)
+		{
+			_tree.assign_sorted(first, last, threads);
+		}
+
+		/* same as assign_sorted, pair i is get(i): anything value_type converts from */
+		template <class Getter>
+		void assign_sorted_by(const Getter& get, size_type n)
+		{
+			_tree.assign_sorted_by(get, n);
 		}
 
 		void clear()
@@ -161,6 +231,23 @@ namespace ft {
 // 23.3.1.3 map operations:
 		iterator	find(const Key& x) { return _tree.find(ft::make_pair(x, mapped_type())); }
 		const_iterator find(const key_type& x) const { return _tree.find(ft::make_pair(x, mapped_type())); }
+
+		/* batched lookups with interleaved descents, one iterator per key to out */
+		template<class InputIterator, class OutputIterator>
+		OutputIterator find_many(InputIterator first, InputIterator last, OutputIterator out)
+		{
+			ft::vector<value_type> batch;
+			batch.reserve(tree_type::find_batch_size);
+			while (first != last)
+			{
+				batch.clear();
+				while (first != last && batch.size() < size_type(tree_type::find_batch_size))
+					batch.push_back(ft::make_pair(*first++, mapped_type()));
+				out = _tree.find_batch(batch.data(), batch.size(), out);
+			}
+			return out;
+		}
+
 		size_type count(const Key& x) const { return _tree.count(ft::make_pair(x, mapped_type())); }
 		iterator lower_bound(const key_type& x) { return _tree.lower_bound(ft::make_pair(x, mapped_type())); }	
 		const_iterator lower_bound(const key_type& x) const { return _tree.lower_bound(ft::make_pair(x, mapped_type())); }	
@@ -224,6 +311,39 @@ namespace ft {
 			return !(lhs < rhs);
 	}
 
+// set algebra on keys: O(n + m) merge walk, result built in O(k), lhs wins on equal keys
+	template<class Key, class T, class Compare, class Alloc>
+	map<Key, T, Compare, Alloc> set_union(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
+	{
+		map<Key, T, Compare, Alloc> res(lhs.key_comp(), lhs._alloc);
+		res._tree.assign_union(lhs._tree, rhs._tree);
+		return res;
+	}
+
+	template<class Key, class T, class Compare, class Alloc>
+	map<Key, T, Compare, Alloc> set_intersection(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
+	{
+		map<Key, T, Compare, Alloc> res(lhs.key_comp(), lhs._alloc);
+		res._tree.assign_intersection(lhs._tree, rhs._tree);
+		return res;
+	}
+
+	template<class Key, class T, class Compare, class Alloc>
+	map<Key, T, Compare, Alloc> set_difference(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
+	{
+		map<Key, T, Compare, Alloc> res(lhs.key_comp(), lhs._alloc);
+		res._tree.assign_difference(lhs._tree, rhs._tree);
+		return res;
+	}
+
+	template<class Key, class T, class Compare, class Alloc>
+	map<Key, T, Compare, Alloc> set_symmetric_difference(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
+	{
+		map<Key, T, Compare, Alloc> res(lhs.key_comp(), lhs._alloc);
+		res._tree.assign_symmetric_difference(lhs._tree, rhs._tree);
+		return res;
+	}
+
 	template<class Key, class T, class Compare, class Alloc>
 	void swap(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
 	{
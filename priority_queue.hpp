@@ -0,0 +1,254 @@
+#ifndef PRIORITY_QUEUE_HPP
+# define PRIORITY_QUEUE_HPP
+
+# include <functional>
+# include "vector.hpp"
+
+namespace ft
+{
+/*
+* 4-ary max-heap (top() is the largest element for Compare = less).
+* Four children share one or two cache lines and the tree is half as
+* deep as a binary heap, so pop() touches fewer lines. Elements are
+* moved through a hole instead of being swapped.
+*/
+	template <class T,
+				class Container = ft::vector<T>,
+				class Compare = std::less<typename Container::value_type> >
+	class priority_queue
+	{
+	public:
+		typedef typename Container::value_type value_type;
+		typedef typename Container::size_type size_type;
+		typedef Container container_type;
+		typedef Compare value_compare;
+	protected:
+		Container c;
+		Compare comp;
+	public:
+		explicit priority_queue(const Compare& x = Compare(), const Container& y = Container()):
+			c(y),
+			comp(x)
+		{
+			_make_heap();
+		}
+
+		template <class InputIterator>
+		priority_queue(InputIterator first, InputIterator last,
+						const Compare& x = Compare(), const Container& y = Container()):
+			c(y),
+			comp(x)
+		{
+			for (; first != last; ++first)
+				c.push_back(*first);
+			_make_heap();
+		}
+
+		bool empty() const { return c.empty(); }
+		size_type size() const { return c.size(); }
+		const value_type& top() const { return c.front(); }
+
+		void push(const value_type& x)
+		{
+			c.push_back(x);
+			_sift_up(c.size() - 1);
+		}
+
+		/* O(n) heapify when the batch outweighs the heap, sift up otherwise */
+		template <class InputIterator>
+		void push_range(InputIterator first, InputIterator last)
+		{
+			size_type old_size = c.size();
+			for (; first != last; ++first)
+				c.push_back(*first);
+			if (c.size() - old_size > old_size)
+				_make_heap();
+			else
+				for (size_type i = old_size; i < c.size(); ++i)
+					_sift_up(i);
+		}
+
+		void pop()
+		{
+			value_type last = c.back();
+			c.pop_back();
+			if (!c.empty())
+				_sift_down(0, last);
+		}
+
+	private:
+		static size_type _parent(size_type i) { return (i - 1) / 4; }
+		static size_type _child(size_type i) { return 4 * i + 1; }
+
+		void _sift_up(size_type i)
+		{
+			value_type x = c[i];
+			while (i > 0 && comp(c[_parent(i)], x))
+			{
+				c[i] = c[_parent(i)];
+				i = _parent(i);
+			}
+			c[i] = x;
+		}
+
+		/* fill hole i with x, pulling the largest child up while it beats x */
+		void _sift_down(size_type i, const value_type& x)
+		{
+			size_type n = c.size();
+			for (;;)
+			{
+				size_type first = _child(i);
+				if (first >= n)
+					break ;
+				size_type last = first + 4 < n ? first + 4 : n;
+				size_type best = first;
+				for (size_type j = first + 1; j < last; ++j)
+					if (comp(c[best], c[j]))
+						best = j;
+				if (!comp(x, c[best]))
+					break ;
+				c[i] = c[best];
+				i = best;
+			}
+			c[i] = x;
+		}
+
+		void _make_heap()
+		{
+			size_type n = c.size();
+			if (n < 2)
+				return ;
+			for (size_type i = _parent(n - 1) + 1; i-- > 0; )
+			{
+				value_type x = c[i];
+				_sift_down(i, x);
+			}
+		}
+	};
+
+/*
+* 4-ary heap whose elements can be reprioritised: push() returns a handle
+* that stays valid until the element is popped or erased. Values live in
+* a slot table indexed by handle, the heap only orders handles, and each
+* slot remembers its heap position so update() is O(log n).
+*/
+	template <class T,
+				class Compare = std::less<T> >
+	class handle_priority_queue
+	{
+	public:
+		typedef T value_type;
+		typedef std::size_t size_type;
+		typedef std::size_t handle_type;
+		typedef Compare value_compare;
+	private:
+		ft::vector<handle_type>	_heap;
+		ft::vector<value_type>	_values;
+		ft::vector<size_type>	_pos;
+		ft::vector<handle_type>	_free;
+		Compare					_comp;
+	public:
+		explicit handle_priority_queue(const Compare& x = Compare()): _comp(x) {}
+
+		bool empty() const { return _heap.empty(); }
+		size_type size() const { return _heap.size(); }
+		const value_type& top() const { return _values[_heap.front()]; }
+		handle_type top_handle() const { return _heap.front(); }
+		const value_type& value(handle_type h) const { return _values[h]; }
+
+		handle_type push(const value_type& x)
+		{
+			handle_type h;
+			if (!_free.empty())
+			{
+				h = _free.back();
+				_free.pop_back();
+				_values[h] = x;
+			}
+			else
+			{
+				h = _values.size();
+				_values.push_back(x);
+				_pos.push_back(0);
+			}
+			_heap.push_back(h);
+			_pos[h] = _heap.size() - 1;
+			_sift_up(_heap.size() - 1);
+			return h;
+		}
+
+		void pop()
+		{
+			erase(_heap.front());
+		}
+
+		/* new priority in either direction ("decrease-key" for a min-heap) */
+		void update(handle_type h, const value_type& x)
+		{
+			bool up = _comp(_values[h], x);
+			_values[h] = x;
+			if (up)
+				_sift_up(_pos[h]);
+			else
+				_sift_down(_pos[h]);
+		}
+
+		void erase(handle_type h)
+		{
+			size_type i = _pos[h];
+			handle_type last = _heap.back();
+			_heap.pop_back();
+			_free.push_back(h);
+			if (last == h)
+				return ;
+			_heap[i] = last;
+			_pos[last] = i;
+			_sift_up(i);
+			_sift_down(_pos[last]);
+		}
+
+	private:
+		bool _less(size_type i, size_type j) const { return _comp(_values[_heap[i]], _values[_heap[j]]); }
+
+		void _place(size_type i, handle_type h)
+		{
+			_heap[i] = h;
+			_pos[h] = i;
+		}
+
+		void _sift_up(size_type i)
+		{
+			handle_type h = _heap[i];
+			while (i > 0 && _comp(_values[_heap[(i - 1) / 4]], _values[h]))
+			{
+				_place(i, _heap[(i - 1) / 4]);
+				i = (i - 1) / 4;
+			}
+			_place(i, h);
+		}
+
+		void _sift_down(size_type i)
+		{
+			handle_type h = _heap[i];
+			size_type n = _heap.size();
+			for (;;)
+			{
+				size_type first = 4 * i + 1;
+				if (first >= n)
+					break ;
+				size_type last = first + 4 < n ? first + 4 : n;
+				size_type best = first;
+				for (size_type j = first + 1; j < last; ++j)
+					if (_less(best, j))
+						best = j;
+				if (!_comp(_values[h], _values[_heap[best]]))
+					break ;
+				_place(i, _heap[best]);
+				i = best;
+			}
+			_place(i, h);
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,902 @@
+#ifndef RADIX_MAP_HPP
+# define RADIX_MAP_HPP
+
+# include <memory>
+# include <algorithm>
+# include "./tree/radix_node.hpp"
+# include "./iter/radix_iterator.hpp"
+# include "./iter/iterator_reverse.hpp"
+# include "./utils/utils.hpp"
+
+namespace ft
+{
+/*
+* Ordered map on an adaptive radix tree (ART): inner nodes of 4, 16, 48
+* or 256 children branch on one key byte and grow or shrink with their
+* child count, single-child paths are compressed into node prefixes.
+* A lookup costs one node per distinct byte position instead of one key
+* comparison per tree level. Order is the byte order of KeyTraits
+* (radix_key: integers numerically, std::string like operator<).
+* Leaves are chained in order, so iteration is a list walk and iterators
+* stay valid until their element is erased.
+*/
+	template <class Key,
+				class T,
+				class KeyTraits = radix_key<Key>,
+				class Allocator = std::allocator<ft::pair<const Key, T> > >
+	class radix_map
+	{
+	public:
+		typedef				Key										key_type;
+		typedef				T										mapped_type;
+		typedef				ft::pair<const Key, T>					value_type;
+		typedef				KeyTraits								key_traits;
+		typedef				Allocator								allocator_type;
+		typedef typename	Allocator::reference					reference;
+		typedef typename	Allocator::const_reference				const_reference;
+		typedef typename	Allocator::pointer						pointer;
+		typedef typename	Allocator::const_pointer				const_pointer;
+		typedef typename	Allocator::size_type					size_type;
+		typedef typename	Allocator::difference_type				difference_type;
+
+		typedef				radix_iterator<value_type>				iterator;
+		typedef				radix_iterator<const value_type>		const_iterator;
+		typedef				ft::reverse_iterator<iterator>			reverse_iterator;
+		typedef				ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+
+	private:
+		typedef				radix_leaf_node<value_type>				leaf_type;
+
+		allocator_type	_alloc;
+		radix_node*		_root;
+		radix_link		_head;		/* list sentinel: _next is the first leaf, _prev the last */
+		size_type		_size;
+		size_type		_bytes;
+
+	public:
+// construct/copy/destroy:
+		explicit radix_map(const allocator_type& alloc = allocator_type()):
+			_alloc(alloc), _root(0), _size(0), _bytes(0)
+		{
+			_head._prev = &_head;
+			_head._next = &_head;
+		}
+
+		template <class InputIterator>
+		radix_map(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type()):
+			_alloc(alloc), _root(0), _size(0), _bytes(0)
+		{
+			_head._prev = &_head;
+			_head._next = &_head;
+			insert(first, last);
+		}
+
+		radix_map(const radix_map& x):
+			_alloc(x._alloc), _root(0), _size(0), _bytes(0)
+		{
+			_head._prev = &_head;
+			_head._next = &_head;
+			_copy(x);
+		}
+
+		radix_map& operator=(const radix_map& x)
+		{
+			if (&x == this)
+				return *this;
+			clear();
+			_alloc = x._alloc;
+			_copy(x);
+			return *this;
+		}
+
+		~radix_map()
+		{
+			clear();
+		}
+
+		allocator_type get_allocator() const { return _alloc; }
+
+// iterators:
+		iterator begin() { return iterator(_head._next); }
+		const_iterator begin() const { return const_iterator(const_cast<radix_link*>(_head._next)); }
+		iterator end() { return iterator(&_head); }
+		const_iterator end() const { return const_iterator(const_cast<radix_link*>(&_head)); }
+		reverse_iterator rbegin() { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+		reverse_iterator rend() { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+// capacity:
+		bool empty() const { return _size == 0; }
+		size_type size() const { return _size; }
+		size_type max_size() const { return _alloc.max_size(); }
+		/* heap bytes held: leaves and inner nodes */
+		size_type memory_usage() const { return _bytes; }
+
+// element access:
+		T& operator[](const key_type& k)
+		{
+			return insert(value_type(k, mapped_type())).first->second;
+		}
+
+// modifiers:
+		ft::pair<iterator, bool> insert(const value_type& v)
+		{
+			const key_type& key = v.first;
+			size_type len = KeyTraits::size(key);
+			if (!_root)
+			{
+				leaf_type* x = _new_leaf(v);
+				_link_before(x, &_head);
+				_root = x;
+				return ft::make_pair(iterator(x), true);
+			}
+			radix_node** ref = &_root;
+			size_type depth = 0;
+			for (;;)
+			{
+				radix_node* node = *ref;
+				if (node->_type == radix_leaf)
+					return _split_leaf(ref, v, depth);
+
+				radix_inner* in = static_cast<radix_inner*>(node);
+				size_type match = _prefix_match(in, key, len, depth);
+				if (match < in->_prefix_len)
+					return _split_prefix(ref, v, depth, match);
+				depth += in->_prefix_len;
+				if (depth == len)
+				{
+					if (in->_leaf)
+						return ft::make_pair(iterator(_leaf(in->_leaf)), false);
+					leaf_type* x = _new_leaf(v);
+					_link_before(x, _minimum(in));
+					in->_leaf = x;
+					return ft::make_pair(iterator(x), true);
+				}
+				unsigned char b = KeyTraits::at(key, depth);
+				radix_node** child = radix_find_child(in, b);
+				if (child)
+				{
+					ref = child;
+					++depth;
+					continue ;
+				}
+				/* the list neighbour is found before a grow frees in */
+				radix_node* prev = radix_prev_child(in, b);
+				radix_link* next;
+				if (prev)
+					next = _maximum(prev)->_next;
+				else if (in->_leaf)
+					next = _leaf(in->_leaf)->_next;
+				else
+					next = _minimum(radix_next_child(in, b));
+				leaf_type* x = _new_leaf(v);
+				try
+				{
+					_add_child(ref, b, x);
+				}
+				catch (...)
+				{
+					_delete_leaf(x);
+					throw ;
+				}
+				_link_before(x, next);
+				return ft::make_pair(iterator(x), true);
+			}
+		}
+
+		iterator insert(iterator position, const value_type& v)
+		{
+			(void)position;
+			return insert(v).first;
+		}
+
+		template <class InputIterator>
+		void insert(InputIterator first, InputIterator last)
+		{
+			while (first != last)
+				insert(*first++);
+		}
+
+		void erase(iterator position)
+		{
+			erase(position->first);
+		}
+
+		size_type erase(const key_type& key)
+		{
+			size_type len = KeyTraits::size(key);
+			radix_node** ref = &_root;
+			radix_node** parent = 0;
+			unsigned char byte = 0;
+			size_type depth = 0;
+			leaf_type* x;
+			for (;;)
+			{
+				radix_node* node = *ref;
+				if (!node)
+					return 0;
+				if (node->_type == radix_leaf)
+				{
+					x = _leaf(node);
+					if (!_equal(x->_value.first, key))
+						return 0;
+					if (!parent)
+						_root = 0;
+					else
+					{
+						radix_remove_child(static_cast<radix_inner*>(*parent), byte);
+						_shrink(parent);
+					}
+					break ;
+				}
+				radix_inner* in = static_cast<radix_inner*>(node);
+				if (!_stored_prefix_match(in, key, len, depth))
+					return 0;
+				depth += in->_prefix_len;
+				if (depth == len)
+				{
+					if (!in->_leaf || !_equal(_leaf(in->_leaf)->_value.first, key))
+						return 0;
+					x = _leaf(in->_leaf);
+					in->_leaf = 0;
+					_shrink(ref);
+					break ;
+				}
+				byte = KeyTraits::at(key, depth);
+				radix_node** child = radix_find_child(in, byte);
+				if (!child)
+					return 0;
+				parent = ref;
+				ref = child;
+				++depth;
+			}
+			_unlink(x);
+			_delete_leaf(x);
+			return 1;
+		}
+
+		void erase(iterator first, iterator last)
+		{
+			while (first != last)
+				erase(first++);
+		}
+
+		void swap(radix_map& other)
+		{
+			std::swap(_alloc, other._alloc);
+			std::swap(_root, other._root);
+			std::swap(_size, other._size);
+			std::swap(_bytes, other._bytes);
+			std::swap(_head, other._head);
+			_fix_head();
+			other._fix_head();
+		}
+
+		void clear()
+		{
+			_destroy(_root);
+			_root = 0;
+			_head._prev = &_head;
+			_head._next = &_head;
+			_size = 0;
+			_bytes = 0;
+		}
+
+// operations:
+		iterator find(const key_type& key) { return iterator(_find(key)); }
+		const_iterator find(const key_type& key) const { return const_iterator(_find(key)); }
+		size_type count(const key_type& key) const { return _find(key) != &_head; }
+
+		iterator lower_bound(const key_type& key) { return iterator(_lower_bound(key)); }
+		const_iterator lower_bound(const key_type& key) const { return const_iterator(_lower_bound(key)); }
+
+		iterator upper_bound(const key_type& key) { return iterator(_upper_bound(key)); }
+		const_iterator upper_bound(const key_type& key) const { return const_iterator(_upper_bound(key)); }
+
+		ft::pair<iterator, iterator> equal_range(const key_type& key)
+		{
+			return ft::make_pair(lower_bound(key), upper_bound(key));
+		}
+
+		ft::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+		{
+			return ft::make_pair(lower_bound(key), upper_bound(key));
+		}
+
+		/* every key starting with the first `bytes` key bytes of prefix: one subtree, no scan */
+		ft::pair<iterator, iterator> prefix_range(const key_type& prefix, size_type bytes)
+		{
+			ft::pair<radix_link*, radix_link*> r = _prefix_range(prefix, bytes);
+			return ft::make_pair(iterator(r.first), iterator(r.second));
+		}
+
+		ft::pair<const_iterator, const_iterator> prefix_range(const key_type& prefix, size_type bytes) const
+		{
+			ft::pair<radix_link*, radix_link*> r = _prefix_range(prefix, bytes);
+			return ft::make_pair(const_iterator(r.first), const_iterator(r.second));
+		}
+
+		/* all of prefix: the keys a string prefix starts */
+		ft::pair<iterator, iterator> prefix_range(const key_type& prefix)
+		{
+			return prefix_range(prefix, KeyTraits::size(prefix));
+		}
+
+		ft::pair<const_iterator, const_iterator> prefix_range(const key_type& prefix) const
+		{
+			return prefix_range(prefix, KeyTraits::size(prefix));
+		}
+
+	private:
+// nodes
+		template <class Node>
+		Node* _new_node()
+		{
+			typename Allocator::template rebind<Node>::other alloc(_alloc);
+			Node* n = alloc.allocate(1);
+			n->_type = Node::type;
+			n->_count = 0;
+			n->_prefix_len = 0;
+			n->_leaf = 0;
+			for (unsigned i = 0; i < Node::capacity; ++i)
+				n->_child[i] = 0;
+			_clear_index(n);
+			_bytes += sizeof(Node);
+			return n;
+		}
+
+		static void _clear_index(radix_inner*) {}
+
+		static void _clear_index(radix_node48* n)
+		{
+			for (unsigned i = 0; i < 256; ++i)
+				n->_index[i] = 0;
+		}
+
+		template <class Node>
+		void _free_node(radix_inner* n)
+		{
+			typename Allocator::template rebind<Node>::other alloc(_alloc);
+			alloc.deallocate(static_cast<Node*>(n), 1);
+			_bytes -= sizeof(Node);
+		}
+
+		/* O(n) structural copy, leaves relinked in order; all or nothing */
+		void _copy(const radix_map& x)
+		{
+			if (!x._root)
+				return ;
+			try
+			{
+				_clone(&_root, x._root);
+			}
+			catch (...)
+			{
+				clear();
+				throw ;
+			}
+		}
+
+		/* each node is reachable from *slot as soon as it exists, so a throw leaves a tree clear() can free */
+		void _clone(radix_node** slot, radix_node* node)
+		{
+			if (node->_type == radix_leaf)
+			{
+				leaf_type* x = _new_leaf(_leaf(node)->_value);
+				_link_before(x, &_head);
+				*slot = x;
+				return ;
+			}
+			radix_inner* in = static_cast<radix_inner*>(node);
+			radix_inner* c;
+			switch (in->_type)
+			{
+			case radix_node4_type: c = _new_node<radix_node4>(); break ;
+			case radix_node16_type: c = _new_node<radix_node16>(); break ;
+			case radix_node48_type: c = _new_node<radix_node48>(); break ;
+			default: c = _new_node<radix_node256>();
+			}
+			c->_prefix_len = in->_prefix_len;
+			for (unsigned i = 0; i < radix_max_prefix; ++i)
+				c->_prefix[i] = in->_prefix[i];
+			*slot = c;
+			if (in->_leaf)
+				_clone(&c->_leaf, in->_leaf);
+			int b = -1;
+			for (radix_node** from = radix_next_slot(in, b); from; from = radix_next_slot(in, b))
+			{
+				radix_node* sub = 0;
+				try
+				{
+					_clone(&sub, *from);
+				}
+				catch (...)
+				{
+					_destroy(sub);
+					throw ;
+				}
+				radix_add_child(c, static_cast<unsigned char>(b), sub);
+			}
+		}
+
+		void _free_inner(radix_inner* n)
+		{
+			switch (n->_type)
+			{
+			case radix_node4_type: _free_node<radix_node4>(n); break ;
+			case radix_node16_type: _free_node<radix_node16>(n); break ;
+			case radix_node48_type: _free_node<radix_node48>(n); break ;
+			default: _free_node<radix_node256>(n);
+			}
+		}
+
+		leaf_type* _new_leaf(const value_type& v)
+		{
+			typename Allocator::template rebind<leaf_type>::other alloc(_alloc);
+			leaf_type* x = alloc.allocate(1);
+			try
+			{
+				_alloc.construct(&x->_value, v);
+			}
+			catch (...)
+			{
+				alloc.deallocate(x, 1);
+				throw ;
+			}
+			x->_type = radix_leaf;
+			_bytes += sizeof(leaf_type);
+			++_size;
+			return x;
+		}
+
+		void _delete_leaf(leaf_type* x)
+		{
+			typename Allocator::template rebind<leaf_type>::other alloc(_alloc);
+			_alloc.destroy(&x->_value);
+			alloc.deallocate(x, 1);
+			_bytes -= sizeof(leaf_type);
+			--_size;
+		}
+
+		void _destroy(radix_node* node)
+		{
+			if (!node)
+				return ;
+			if (node->_type == radix_leaf)
+			{
+				_delete_leaf(_leaf(node));
+				return ;
+			}
+			radix_inner* in = static_cast<radix_inner*>(node);
+			_destroy(in->_leaf);
+			int b = -1;
+			for (radix_node** c = radix_next_slot(in, b); c; c = radix_next_slot(in, b))
+				_destroy(*c);
+			_free_inner(in);
+		}
+
+		/* room for one more child of *ref, growing it to the next size */
+		void _add_child(radix_node** ref, unsigned char b, radix_node* c)
+		{
+			radix_inner* in = static_cast<radix_inner*>(*ref);
+			if (in->_count == radix_capacity(in))
+			{
+				radix_inner* bigger;
+				if (in->_type == radix_node4_type)
+					bigger = _new_node<radix_node16>();
+				else if (in->_type == radix_node16_type)
+					bigger = _new_node<radix_node48>();
+				else
+					bigger = _new_node<radix_node256>();
+				radix_move_node(in, bigger);
+				_free_inner(in);
+				*ref = bigger;
+				in = bigger;
+			}
+			radix_add_child(in, b, c);
+		}
+
+		/* after a removal: shrink *ref when well under its size, fold a lone child into it */
+		void _shrink(radix_node** ref)
+		{
+			radix_inner* in = static_cast<radix_inner*>(*ref);
+			unsigned limit;
+			switch (in->_type)
+			{
+			case radix_node4_type:
+				if (in->_count + (in->_leaf != 0) > 1)
+					return ;
+				if (in->_leaf)
+					*ref = in->_leaf;
+				else
+				{
+					radix_node4* n4 = static_cast<radix_node4*>(in);
+					radix_node* child = n4->_child[0];
+					if (child->_type != radix_leaf)
+						_fold_prefix(in, n4->_keys[0], static_cast<radix_inner*>(child));
+					*ref = child;
+				}
+				_free_inner(in);
+				return ;
+			case radix_node16_type: limit = 3; break ;
+			case radix_node48_type: limit = 12; break ;
+			default: limit = 37;
+			}
+			if (in->_count > limit)
+				return ;
+			radix_inner* smaller;
+			try
+			{
+				if (in->_type == radix_node16_type)
+					smaller = _new_node<radix_node4>();
+				else if (in->_type == radix_node48_type)
+					smaller = _new_node<radix_node16>();
+				else
+					smaller = _new_node<radix_node48>();
+			}
+			catch (...)
+			{
+				/* erase does not throw: keep the bigger node */
+				return ;
+			}
+			radix_move_node(in, smaller);
+			_free_inner(in);
+			*ref = smaller;
+		}
+
+		/* child takes parent's prefix and the byte between them in front of its own */
+		void _fold_prefix(radix_inner* parent, unsigned char b, radix_inner* child)
+		{
+			unsigned char buf[radix_max_prefix];
+			unsigned n = 0;
+			for (unsigned i = 0; i < parent->_prefix_len && n < radix_max_prefix; ++i)
+				buf[n++] = parent->_prefix[i];
+			if (n < radix_max_prefix)
+				buf[n++] = b;
+			for (unsigned i = 0; i < child->_prefix_len && n < radix_max_prefix; ++i)
+				buf[n++] = child->_prefix[i];
+			for (unsigned i = 0; i < n; ++i)
+				child->_prefix[i] = buf[i];
+			child->_prefix_len += parent->_prefix_len + 1;
+		}
+
+// key bytes
+		static leaf_type* _leaf(radix_node* n) { return static_cast<leaf_type*>(n); }
+
+		static bool _equal(const key_type& a, const key_type& b)
+		{
+			size_type len = KeyTraits::size(a);
+			if (len != KeyTraits::size(b))
+				return false;
+			for (size_type i = 0; i < len; ++i)
+				if (KeyTraits::at(a, i) != KeyTraits::at(b, i))
+					return false;
+			return true;
+		}
+
+		/* byte i of the prefix of in, which starts at depth */
+		unsigned char _prefix_byte(radix_inner* in, size_type depth, size_type i) const
+		{
+			if (i < radix_max_prefix)
+				return in->_prefix[i];
+			return KeyTraits::at(_minimum(in)->_value.first, depth + i);
+		}
+
+		/* prefix bytes of in equal to key from depth on, the unstored tail included */
+		size_type _prefix_match(radix_inner* in, const key_type& key, size_type len, size_type depth) const
+		{
+			size_type i = 0;
+			for (; i < in->_prefix_len; ++i)
+				if (depth + i >= len || KeyTraits::at(key, depth + i) != _prefix_byte(in, depth, i))
+					break ;
+			return i;
+		}
+
+		/* optimistic check for lookups: the unstored tail is verified at the leaf */
+		static bool _stored_prefix_match(radix_inner* in, const key_type& key, size_type len, size_type depth)
+		{
+			if (depth + in->_prefix_len > len)
+				return false;
+			size_type stored = in->_prefix_len < size_type(radix_max_prefix) ? in->_prefix_len : size_type(radix_max_prefix);
+			for (size_type i = 0; i < stored; ++i)
+				if (KeyTraits::at(key, depth + i) != in->_prefix[i])
+					return false;
+			return true;
+		}
+
+// tree walks
+		static leaf_type* _minimum(radix_node* n)
+		{
+			while (n->_type != radix_leaf)
+			{
+				radix_inner* in = static_cast<radix_inner*>(n);
+				if (in->_leaf)
+					return _leaf(in->_leaf);
+				n = radix_next_child(in, -1);
+			}
+			return _leaf(n);
+		}
+
+		static leaf_type* _maximum(radix_node* n)
+		{
+			while (n->_type != radix_leaf)
+			{
+				radix_inner* in = static_cast<radix_inner*>(n);
+				radix_node* last = radix_prev_child(in, 256);
+				if (!last)
+					return _leaf(in->_leaf);
+				n = last;
+			}
+			return _leaf(n);
+		}
+
+		radix_link* _find(const key_type& key) const
+		{
+			size_type len = KeyTraits::size(key);
+			radix_node* node = _root;
+			size_type depth = 0;
+			while (node)
+			{
+				if (node->_type == radix_leaf)
+					break ;
+				radix_inner* in = static_cast<radix_inner*>(node);
+				if (!_stored_prefix_match(in, key, len, depth))
+					return const_cast<radix_link*>(&_head);
+				depth += in->_prefix_len;
+				if (depth == len)
+				{
+					node = in->_leaf;
+					break ;
+				}
+				radix_node** child = radix_find_child(in, KeyTraits::at(key, depth));
+				node = child ? *child : 0;
+				if (node)
+					FT_PREFETCH(node);
+				++depth;
+			}
+			if (node && _equal(_leaf(node)->_value.first, key))
+				return _leaf(node);
+			return const_cast<radix_link*>(&_head);
+		}
+
+		/* a < b in byte order, both equal before depth */
+		static bool _less(const key_type& a, const key_type& b, size_type depth)
+		{
+			size_type la = KeyTraits::size(a);
+			size_type lb = KeyTraits::size(b);
+			for (size_type i = depth; i < la && i < lb; ++i)
+			{
+				unsigned char x = KeyTraits::at(a, i);
+				unsigned char y = KeyTraits::at(b, i);
+				if (x != y)
+					return x < y;
+			}
+			return la < lb;
+		}
+
+		radix_link* _lower_bound(const key_type& key) const
+		{
+			size_type len = KeyTraits::size(key);
+			radix_node* node = _root;
+			size_type depth = 0;
+			while (node)
+			{
+				if (node->_type == radix_leaf)
+				{
+					leaf_type* x = _leaf(node);
+					return _less(x->_value.first, key, depth) ? x->_next : x;
+				}
+				radix_inner* in = static_cast<radix_inner*>(node);
+				for (size_type i = 0; i < in->_prefix_len; ++i)
+				{
+					/* the whole subtree is on one side of key */
+					if (depth + i == len)
+						return _minimum(in);
+					unsigned char p = _prefix_byte(in, depth, i);
+					unsigned char k = KeyTraits::at(key, depth + i);
+					if (p != k)
+						return p > k ? _minimum(in) : _maximum(in)->_next;
+				}
+				depth += in->_prefix_len;
+				if (depth == len)
+					return _minimum(in);
+				unsigned char b = KeyTraits::at(key, depth);
+				radix_node** child = radix_find_child(in, b);
+				if (!child)
+				{
+					radix_node* next = radix_next_child(in, b);
+					return next ? _minimum(next) : _maximum(in)->_next;
+				}
+				node = *child;
+				++depth;
+			}
+			return const_cast<radix_link*>(&_head);
+		}
+
+		radix_link* _upper_bound(const key_type& key) const
+		{
+			radix_link* x = _lower_bound(key);
+			if (x != &_head && _equal(static_cast<leaf_type*>(x)->_value.first, key))
+				x = x->_next;
+			return x;
+		}
+
+		ft::pair<radix_link*, radix_link*> _prefix_range(const key_type& prefix, size_type bytes) const
+		{
+			radix_link* none = const_cast<radix_link*>(&_head);
+			radix_node* node = _root;
+			size_type depth = 0;
+			if (bytes > KeyTraits::size(prefix))
+				bytes = KeyTraits::size(prefix);
+			while (node)
+			{
+				if (node->_type == radix_leaf)
+				{
+					leaf_type* x = _leaf(node);
+					const key_type& k = x->_value.first;
+					if (KeyTraits::size(k) < bytes)
+						break ;
+					for (size_type i = depth; i < bytes; ++i)
+						if (KeyTraits::at(k, i) != KeyTraits::at(prefix, i))
+							return ft::make_pair(none, none);
+					return ft::make_pair(static_cast<radix_link*>(x), x->_next);
+				}
+				radix_inner* in = static_cast<radix_inner*>(node);
+				for (size_type i = 0; i < in->_prefix_len && depth + i < bytes; ++i)
+					if (_prefix_byte(in, depth, i) != KeyTraits::at(prefix, depth + i))
+						return ft::make_pair(none, none);
+				depth += in->_prefix_len;
+				if (depth >= bytes)
+					return ft::make_pair(_minimum(in), _maximum(in)->_next);
+				radix_node** child = radix_find_child(in, KeyTraits::at(prefix, depth));
+				node = child ? *child : 0;
+				++depth;
+			}
+			return ft::make_pair(none, none);
+		}
+
+// insert cases
+		/* the node4 of a split and the new leaf, both or neither */
+		radix_node4* _new_split(const value_type& v, leaf_type*& x)
+		{
+			radix_node4* n = _new_node<radix_node4>();
+			try
+			{
+				x = _new_leaf(v);
+			}
+			catch (...)
+			{
+				_free_inner(n);
+				throw ;
+			}
+			return n;
+		}
+
+		/* *ref is a leaf: both keys go under a new node4 holding their common bytes */
+		ft::pair<iterator, bool> _split_leaf(radix_node** ref, const value_type& v, size_type depth)
+		{
+			leaf_type* old = _leaf(*ref);
+			const key_type& key = v.first;
+			const key_type& other = old->_value.first;
+			size_type len = KeyTraits::size(key);
+			size_type olen = KeyTraits::size(other);
+			size_type i = depth;
+			while (i < len && i < olen && KeyTraits::at(key, i) == KeyTraits::at(other, i))
+				++i;
+			if (i == len && i == olen)
+				return ft::make_pair(iterator(old), false);
+
+			leaf_type* x;
+			radix_node4* n = _new_split(v, x);
+			n->_prefix_len = static_cast<unsigned>(i - depth);
+			for (size_type j = 0; j < n->_prefix_len && j < size_type(radix_max_prefix); ++j)
+				n->_prefix[j] = KeyTraits::at(key, depth + j);
+			if (i == olen)
+				n->_leaf = old;
+			else
+				radix_add_child(n, KeyTraits::at(other, i), old);
+			if (i == len)
+				n->_leaf = x;
+			else
+				radix_add_child(n, KeyTraits::at(key, i), x);
+			*ref = n;
+			if (i == len || (i < olen && KeyTraits::at(key, i) < KeyTraits::at(other, i)))
+				_link_before(x, old);
+			else
+				_link_after(x, old);
+			return ft::make_pair(iterator(x), true);
+		}
+
+		/* key leaves the prefix of *ref after match bytes: a new node4 takes the shared part */
+		ft::pair<iterator, bool> _split_prefix(radix_node** ref, const value_type& v, size_type depth, size_type match)
+		{
+			radix_inner* in = static_cast<radix_inner*>(*ref);
+			const key_type& key = v.first;
+			size_type len = KeyTraits::size(key);
+			leaf_type* first = _minimum(in);
+			leaf_type* last = _maximum(in);
+
+			leaf_type* x;
+			radix_node4* n = _new_split(v, x);
+			n->_prefix_len = static_cast<unsigned>(match);
+			for (size_type j = 0; j < match && j < size_type(radix_max_prefix); ++j)
+				n->_prefix[j] = in->_prefix[j];
+			unsigned char b = _prefix_byte(in, depth, match);
+
+			/* in keeps what follows b, the stored bytes are shifted or reread */
+			unsigned char buf[radix_max_prefix];
+			size_type rest = in->_prefix_len - match - 1;
+			for (size_type j = 0; j < rest && j < size_type(radix_max_prefix); ++j)
+				buf[j] = _prefix_byte(in, depth, match + 1 + j);
+			for (size_type j = 0; j < rest && j < size_type(radix_max_prefix); ++j)
+				in->_prefix[j] = buf[j];
+			in->_prefix_len = static_cast<unsigned>(rest);
+			radix_add_child(n, b, in);
+
+			if (depth + match == len)
+				n->_leaf = x;
+			else
+				radix_add_child(n, KeyTraits::at(key, depth + match), x);
+			*ref = n;
+			if (depth + match == len || KeyTraits::at(key, depth + match) < b)
+				_link_before(x, first);
+			else
+				_link_after(x, last);
+			return ft::make_pair(iterator(x), true);
+		}
+
+// leaf list
+		static void _link_before(radix_link* x, radix_link* pos)
+		{
+			x->_prev = pos->_prev;
+			x->_next = pos;
+			pos->_prev->_next = x;
+			pos->_prev = x;
+		}
+
+		static void _link_after(radix_link* x, radix_link* pos)
+		{
+			_link_before(x, pos->_next);
+		}
+
+		static void _unlink(radix_link* x)
+		{
+			x->_prev->_next = x->_next;
+			x->_next->_prev = x->_prev;
+		}
+
+		/* after the heads were exchanged: the end leaves point back at this head */
+		void _fix_head()
+		{
+			if (_size == 0)
+			{
+				_head._prev = &_head;
+				_head._next = &_head;
+				return ;
+			}
+			_head._next->_prev = &_head;
+			_head._prev->_next = &_head;
+		}
+	};
+
+	template <class Key, class T, class Traits, class Alloc>
+	bool operator==(const radix_map<Key, T, Traits, Alloc>& lhs, const radix_map<Key, T, Traits, Alloc>& rhs)
+	{
+		return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	template <class Key, class T, class Traits, class Alloc>
+	bool operator!=(const radix_map<Key, T, Traits, Alloc>& lhs, const radix_map<Key, T, Traits, Alloc>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <class Key, class T, class Traits, class Alloc>
+	void swap(radix_map<Key, T, Traits, Alloc>& lhs, radix_map<Key, T, Traits, Alloc>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+}
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef RING_QUEUE_HPP
+# define RING_QUEUE_HPP
+
+# include <memory>
+# include <cstddef>
+
+# define FT_CACHE_LINE 64
+
+namespace ft
+{
+	enum ring_mode
+	{
+		spsc,
+		mpmc
+	};
+
+/*
+* Bounded FIFO over one contiguous block of cells, capacity rounded up
+* to a power of two (Vyukov's sequence-numbered ring).
+* Every cell carries a sequence number telling whether it is free for
+* the producer at position pos (seq == pos) or filled for the consumer
+* (seq == pos + 1). In mpmc mode head/tail are claimed with a CAS, in
+* spsc mode each index has a single writer and a plain store is enough.
+* head and tail sit on their own cache lines to avoid false sharing.
+* A claimed cell cannot be given back: T's copy constructor must not throw.
+* Uses the GCC/clang __atomic builtins.
+*/
+	template <class T,
+				ring_mode Mode = mpmc,
+				class Allocator = std::allocator<T> >
+	class ring_queue
+	{
+	public:
+		typedef				T												value_type;
+		typedef				Allocator										allocator_type;
+		typedef				std::size_t										size_type;
+
+	private:
+		struct Cell
+		{
+			size_type	_seq;
+			T			_value;
+		};
+
+		/* an index alone on its cache line */
+		struct index_line
+		{
+			char		_before[FT_CACHE_LINE - sizeof(size_type)];
+			size_type	_value;
+			char		_after[FT_CACHE_LINE - sizeof(size_type)];
+		};
+
+		typedef typename	allocator_type::template rebind<Cell>::other	allocator_cell;
+
+		allocator_cell		_alloc_cell;
+		allocator_type		_alloc_value;
+		Cell*				_cells;
+		size_type			_mask;
+		index_line			_head;
+		index_line			_tail;
+
+		ring_queue(const ring_queue&);
+		ring_queue& operator=(const ring_queue&);
+
+	public:
+		explicit ring_queue(size_type capacity, const allocator_type& alloc = allocator_type()):
+			_alloc_cell(alloc),
+			_alloc_value(alloc),
+			_cells(NULL),
+			_mask(0)
+		{
+			_head._value = 0;
+			_tail._value = 0;
+			size_type n = 2;
+			while (n < capacity)
+				n <<= 1;
+			_cells = _alloc_cell.allocate(n);
+			_mask = n - 1;
+			for (size_type i = 0; i < n; ++i)
+				_cells[i]._seq = i;
+		}
+
+		~ring_queue()
+		{
+			for (size_type pos = _head._value; pos != _tail._value; ++pos)
+				_alloc_value.destroy(&_cells[pos & _mask]._value);
+			_alloc_cell.deallocate(_cells, _mask + 1);
+		}
+
+		size_type capacity() const { return _mask + 1; }
+
+		/* exact only while no other thread is pushing or popping */
+		size_type size() const
+		{
+			return __atomic_load_n(&_tail._value, __ATOMIC_RELAXED) - __atomic_load_n(&_head._value, __ATOMIC_RELAXED);
+		}
+
+		bool empty() const { return size() == 0; }
+
+		/* false when full */
+		bool push(const value_type& x)
+		{
+			size_type pos = __atomic_load_n(&_tail._value, __ATOMIC_RELAXED);
+			Cell* cell;
+			for (;;)
+			{
+				cell = &_cells[pos & _mask];
+				size_type seq = __atomic_load_n(&cell->_seq, __ATOMIC_ACQUIRE);
+				std::ptrdiff_t dif = std::ptrdiff_t(seq) - std::ptrdiff_t(pos);
+				if (dif < 0)
+					return false;
+				if (dif > 0)
+					pos = __atomic_load_n(&_tail._value, __ATOMIC_RELAXED);
+				else if (Mode == spsc)
+				{
+					__atomic_store_n(&_tail._value, pos + 1, __ATOMIC_RELAXED);
+					break ;
+				}
+				else if (__atomic_compare_exchange_n(&_tail._value, &pos, pos + 1,
+							true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+					break ;
+			}
+			_alloc_value.construct(&cell->_value, x);
+			__atomic_store_n(&cell->_seq, pos + 1, __ATOMIC_RELEASE);
+			return true;
+		}
+
+		/* false when empty, x is left untouched then */
+		bool pop(value_type& x)
+		{
+			size_type pos = __atomic_load_n(&_head._value, __ATOMIC_RELAXED);
+			Cell* cell;
+			for (;;)
+			{
+				cell = &_cells[pos & _mask];
+				size_type seq = __atomic_load_n(&cell->_seq, __ATOMIC_ACQUIRE);
+				std::ptrdiff_t dif = std::ptrdiff_t(seq) - std::ptrdiff_t(pos + 1);
+				if (dif < 0)
+					return false;
+				if (dif > 0)
+					pos = __atomic_load_n(&_head._value, __ATOMIC_RELAXED);
+				else if (Mode == spsc)
+				{
+					__atomic_store_n(&_head._value, pos + 1, __ATOMIC_RELAXED);
+					break ;
+				}
+				else if (__atomic_compare_exchange_n(&_head._value, &pos, pos + 1,
+							true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+					break ;
+			}
+			x = cell->_value;
+			_alloc_value.destroy(&cell->_value);
+			__atomic_store_n(&cell->_seq, pos + _mask + 1, __ATOMIC_RELEASE);
+			return true;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,318 @@
+#ifndef SERIALIZE_HPP
+# define SERIALIZE_HPP
+
+# include <ostream>
+# include <stdexcept>
+# include <cstring>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
+# include "vector.hpp"
+# include "map.hpp"
+# include "set.hpp"
+# include "./iter/iterator_random_access.hpp"
+
+namespace ft
+{
+/*
+* Binary format for containers of trivially copyable types: a 32-byte
+* header, then the elements as one raw array in native byte order (same
+* ABI only). map records have ft::pair<Key, T>'s size and member offsets,
+* in key order, padding zeroed, and are copied member by member both
+* ways; set records are the keys. The writers stream to any ostream;
+* the loaders mmap the file: mapped_vector reads it in place, maps and
+* sets are rebuilt with the O(n) sorted bulk load.
+*/
+	enum binary_kind
+	{
+		binary_vector = 1,
+		binary_map = 2,
+		binary_set = 3
+	};
+
+	struct binary_header
+	{
+		char				magic[4];
+		unsigned int		kind;
+		unsigned int		element_size;
+		unsigned int		reserved;
+		unsigned long long	count;
+		unsigned long long	reserved2;
+	};
+
+	/* read-only private mapping of a whole file */
+	class mapped_file
+	{
+	private:
+		char*		_data;
+		std::size_t	_size;
+
+		mapped_file(const mapped_file&);
+		mapped_file& operator=(const mapped_file&);
+
+	public:
+		explicit mapped_file(const char* path):
+			_data(t_nullptr),
+			_size(0)
+		{
+			int fd = ::open(path, O_RDONLY);
+			if (fd < 0)
+				throw std::runtime_error("mapped_file: cannot open file");
+			struct stat st;
+			if (::fstat(fd, &st) < 0)
+			{
+				::close(fd);
+				throw std::runtime_error("mapped_file: cannot stat file");
+			}
+			_size = st.st_size;
+			void* p = _size ? ::mmap(t_nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0) : t_nullptr;
+			::close(fd);
+			if (p == MAP_FAILED)
+				throw std::runtime_error("mapped_file: mmap failed");
+			_data = static_cast<char*>(p);
+		}
+
+		~mapped_file()
+		{
+			if (_data)
+				::munmap(_data, _size);
+		}
+
+		const char* data() const { return _data; }
+		std::size_t size() const { return _size; }
+
+		/* whole file will be read front to back once */
+		void advise_sequential() const
+		{
+			if (_data)
+				::madvise(_data, _size, MADV_SEQUENTIAL);
+		}
+	};
+
+	/* checks the header, returns the first element's bytes and the element count */
+	inline const char* binary_payload_bytes(const mapped_file& file, binary_kind kind,
+												std::size_t element_size, std::size_t& count)
+	{
+		binary_header h;
+		if (file.size() < sizeof(h))
+			throw std::runtime_error("binary_payload: truncated header");
+		std::memcpy(&h, file.data(), sizeof(h));
+		if (std::memcmp(h.magic, "FTC1", 4) != 0 || h.kind != unsigned(kind) || h.element_size != element_size)
+			throw std::runtime_error("binary_payload: wrong format");
+		if (h.count > (file.size() - sizeof(h)) / element_size)
+			throw std::runtime_error("binary_payload: truncated data");
+		count = h.count;
+		return file.data() + sizeof(h);
+	}
+
+	/* same, as an array of T (T trivially copyable) */
+	template <class T>
+	const T* binary_payload(const mapped_file& file, binary_kind kind, std::size_t& count)
+	{
+		return reinterpret_cast<const T*>(binary_payload_bytes(file, kind, sizeof(T), count));
+	}
+
+	/* a map record is sizeof(ft::pair<Key, T>) bytes: the key at 0, the value at this offset */
+	template <class Key, class T>
+	std::size_t binary_map_second()
+	{
+		static const ft::pair<Key, T> probe = ft::pair<Key, T>();
+		return reinterpret_cast<const char*>(&probe.second) - reinterpret_cast<const char*>(&probe);
+	}
+
+	/* map records read member by member, ft::pair itself is not trivially copyable */
+	template <class Key, class T>
+	struct binary_map_records
+	{
+		const char*	_data;
+		std::size_t	_second;
+
+		binary_map_records(const char* data): _data(data), _second(binary_map_second<Key, T>()) {}
+
+		Key key(std::size_t i) const
+		{
+			Key k;
+			std::memcpy(&k, _data + i * sizeof(ft::pair<Key, T>), sizeof(Key));
+			return k;
+		}
+
+		ft::pair<Key, T> operator()(std::size_t i) const
+		{
+			ft::pair<Key, T> r;
+			std::memcpy(&r.first, _data + i * sizeof(ft::pair<Key, T>), sizeof(Key));
+			std::memcpy(&r.second, _data + i * sizeof(ft::pair<Key, T>) + _second, sizeof(T));
+			return r;
+		}
+	};
+
+	inline void write_binary_header(std::ostream& os, binary_kind kind, std::size_t element_size, std::size_t count)
+	{
+		binary_header h;
+		std::memset(&h, 0, sizeof(h));
+		std::memcpy(h.magic, "FTC1", 4);
+		h.kind = kind;
+		h.element_size = element_size;
+		h.count = count;
+		os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+	}
+
+/*
+* Zero-copy vector view of a file written by write_binary(vector):
+* elements are read straight from the page cache.
+*/
+	template <class T>
+	class mapped_vector
+	{
+	public:
+		typedef				T												value_type;
+		typedef				std::size_t										size_type;
+		typedef				std::ptrdiff_t									difference_type;
+		typedef				const T&										const_reference;
+		typedef				const T*										const_pointer;
+		typedef				ft::random_access_iterator<const_pointer>		const_iterator;
+		typedef				ft::reverse_iterator<const_iterator>			const_reverse_iterator;
+	private:
+		mapped_file		_file;
+		const T*		_data;
+		size_type		_size;
+
+		mapped_vector(const mapped_vector&);
+		mapped_vector& operator=(const mapped_vector&);
+
+	public:
+		explicit mapped_vector(const char* path,
+								typename ft::enable_if<ft::is_trivially_copyable<T>::value>::type* = t_nullptr):
+			_file(path),
+			_data(t_nullptr),
+			_size(0)
+		{
+			_data = binary_payload<T>(_file, binary_vector, _size);
+		}
+
+		const_iterator begin() const { return const_iterator(_data); }
+		const_iterator end() const { return const_iterator(_data + _size); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+		size_type size() const { return _size; }
+		bool empty() const { return _size == 0; }
+		const_pointer data() const { return _data; }
+
+		const_reference operator[](size_type n) const { return _data[n]; }
+		const_reference front() const { return _data[0]; }
+		const_reference back() const { return _data[_size - 1]; }
+
+		const_reference at(size_type n) const
+		{
+			if (n >= _size)
+				throw (std::out_of_range("mapped_vector"));
+			return _data[n];
+		}
+	};
+
+//writers:
+	template <class T, class Alloc>
+	typename ft::enable_if<ft::is_trivially_copyable<T>::value, std::ostream&>::type
+	write_binary(std::ostream& os, const vector<T, Alloc>& v)
+	{
+		write_binary_header(os, binary_vector, sizeof(T), v.size());
+		if (!v.empty())
+			os.write(reinterpret_cast<const char*>(&v[0]), v.size() * sizeof(T));
+		return os;
+	}
+
+	/* records go through a 64 KiB staging buffer, one ostream::write per chunk */
+	template <class Key, class T, class Compare, class Alloc>
+	typename ft::enable_if<ft::is_trivially_copyable<Key>::value && ft::is_trivially_copyable<T>::value, std::ostream&>::type
+	write_binary(std::ostream& os, const map<Key, T, Compare, Alloc>& m)
+	{
+		typedef ft::pair<Key, T> record;
+		enum { chunk = 65536 / sizeof(record) + 1 };
+		const std::size_t second = binary_map_second<Key, T>();
+
+		char buf[chunk * sizeof(record)];
+		std::size_t n = 0;
+		write_binary_header(os, binary_map, sizeof(record), m.size());
+		for (typename map<Key, T, Compare, Alloc>::const_iterator it = m.begin(); it != m.end(); ++it)
+		{
+			char* slot = buf + n * sizeof(record);
+			std::memset(slot, 0, sizeof(record));
+			std::memcpy(slot, &it->first, sizeof(Key));
+			std::memcpy(slot + second, &it->second, sizeof(T));
+			if (++n == chunk)
+			{
+				os.write(buf, n * sizeof(record));
+				n = 0;
+			}
+		}
+		os.write(buf, n * sizeof(record));
+		return os;
+	}
+
+	template <class Key, class Compare, class Alloc>
+	typename ft::enable_if<ft::is_trivially_copyable<Key>::value, std::ostream&>::type
+	write_binary(std::ostream& os, const set<Key, Compare, Alloc>& s)
+	{
+		enum { chunk = 65536 / sizeof(Key) + 1 };
+
+		char buf[chunk * sizeof(Key)];
+		std::size_t n = 0;
+		write_binary_header(os, binary_set, sizeof(Key), s.size());
+		for (typename set<Key, Compare, Alloc>::const_iterator it = s.begin(); it != s.end(); ++it)
+		{
+			std::memcpy(buf + n * sizeof(Key), &*it, sizeof(Key));
+			if (++n == chunk)
+			{
+				os.write(buf, n * sizeof(Key));
+				n = 0;
+			}
+		}
+		os.write(buf, n * sizeof(Key));
+		return os;
+	}
+
+//loaders (replace the content, throw std::runtime_error on a bad file):
+	template <class T, class Alloc>
+	typename ft::enable_if<ft::is_trivially_copyable<T>::value>::type
+	load_binary(const char* path, vector<T, Alloc>& v)
+	{
+		mapped_file file(path);
+		std::size_t n;
+		const T* data = binary_payload<T>(file, binary_vector, n);
+		v.assign(data, data + n);
+	}
+
+	/* keys are checked to be strictly increasing before the bulk build */
+	template <class Key, class T, class Compare, class Alloc>
+	typename ft::enable_if<ft::is_trivially_copyable<Key>::value && ft::is_trivially_copyable<T>::value>::type
+	load_binary(const char* path, map<Key, T, Compare, Alloc>& m)
+	{
+		mapped_file file(path);
+		file.advise_sequential();
+		std::size_t n;
+		binary_map_records<Key, T> records(binary_payload_bytes(file, binary_map, sizeof(ft::pair<Key, T>), n));
+		Compare comp = m.key_comp();
+		for (std::size_t i = 1; i < n; i++)
+			if (!comp(records.key(i - 1), records.key(i)))
+				throw std::runtime_error("load_binary: keys not sorted");
+		m.assign_sorted_by(records, n);
+	}
+
+	template <class Key, class Compare, class Alloc>
+	typename ft::enable_if<ft::is_trivially_copyable<Key>::value>::type
+	load_binary(const char* path, set<Key, Compare, Alloc>& s)
+	{
+		mapped_file file(path);
+		file.advise_sequential();
+		std::size_t n;
+		const Key* data = binary_payload<Key>(file, binary_set, n);
+		Compare comp = s.key_comp();
+		for (std::size_t i = 1; i < n; i++)
+			if (!comp(data[i - 1], data[i]))
+				throw std::runtime_error("load_binary: keys not sorted");
+		s.assign_sorted(data, data + n);
+	}
+}
+
+#endif
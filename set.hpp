@@ -29,6 +29,7 @@ namespace ft
 		typedef typename tree_type::const_iterator					const_iterator;
 		typedef typename tree_type::reverse_iterator				reverse_iterator;
 		typedef typename tree_type::const_reverse_iterator			const_reverse_iterator;
+		typedef typename tree_type::node_type						node_type;
 
 	private:
 		tree_type _tree;
@@ -77,6 +78,10 @@ namespace ft
 		bool empty() const { return _tree.empty(); }
 		size_type size() const { return _tree.size(); }
 		size_type max_size() const { return _tree.max_size(); }
+		size_type memory_usage() const { return _tree.memory_usage(); }
+		/* comparator calls, rotations, recolorings (-DFT_RBTREE_TELEMETRY) and depths */
+		rbtree_telemetry telemetry() const { return _tree.telemetry(); }
+		void reset_telemetry() { _tree.reset_telemetry(); }
 
 // modifiers:
 		ft::pair<iterator, bool> insert( const value_type& x)
@@ -118,6 +123,41 @@ namespace ft
 			_tree.swap(other._tree);
 		}
 
+// C++17 node handles: relink nodes between containers, no allocation, no copy
+		node_type extract(iterator position)
+		{
+			return _tree.extract(position);
+		}
+
+		node_type extract(const key_type& x)
+		{
+			return _tree.extract(x);
+		}
+
+		pair<iterator, bool> insert(node_type& nh)
+		{
+			return _tree.insert(nh);
+		}
+
+		void merge(set& source)
+		{
+			_tree.merge(source._tree);
+		}
+
+		/* O(n) bulk load, [first, last) must be sorted and duplicate-free */
+		template <class RandomIt>
+		void assign_sorted(RandomIt first, RandomIt last)
+		{
+			_tree.assign_sorted(first, last);
+		}
+
+		/* same, built on `threads` threads (thread-safe allocator required) */
+		template <class RandomIt>
+		void assign_sorted(RandomIt first, RandomIt last, unsigned threads)
+		{
+			_tree.assign_sorted(first, last, threads);
+		}
+
 		void clear(){
 			_tree.clear();
 		}	
@@ -128,9 +168,11 @@ namespace ft
 
 // set operations:
 		iterator find(const key_type& x) { return _tree.find(x); }
+		template<class InputIterator, class OutputIterator>
+		OutputIterator find_many(InputIterator first, InputIterator last, OutputIterator out) { return _tree.find_many(first, last, out); }
 		size_type count(const key_type &x) const { return _tree.count(x); }
 		iterator lower_bound(const key_type& x) { return _tree.lower_bound(x); }
-		iterator upper_bound(const key_type& x) { return _tree.lower_bound(x); }
+		iterator upper_bound(const key_type& x) { return _tree.upper_bound(x); }
 		pair<iterator, iterator> equal_range(const key_type & x) { return _tree.equal_range(x); }
 
 		template<class K, class Com, class Al>
@@ -138,6 +180,18 @@ namespace ft
 
 		template<class K, class Com, class Al>
 		friend bool operator<(const set<K, Com, Al>& lhs, const set<K, Com, Al>& rhs);
+
+		template<class K, class Com, class Al>
+		friend set<K, Com, Al> set_union(const set<K, Com, Al>& lhs, const set<K, Com, Al>& rhs);
+
+		template<class K, class Com, class Al>
+		friend set<K, Com, Al> set_intersection(const set<K, Com, Al>& lhs, const set<K, Com, Al>& rhs);
+
+		template<class K, class Com, class Al>
+		friend set<K, Com, Al> set_difference(const set<K, Com, Al>& lhs, const set<K, Com, Al>& rhs);
+
+		template<class K, class Com, class Al>
+		friend set<K, Com, Al> set_symmetric_difference(const set<K, Com, Al>& lhs, const set<K, Com, Al>& rhs);
 	};
 
 	template<class Key, class Compare, class Alloc>
@@ -176,6 +230,39 @@ namespace ft
 		return !(lhs < rhs);
 	}
 
+// set algebra: O(n + m) merge walk, result built in O(k)
+	template<class Key, class Compare, class Alloc>
+	set<Key, Compare, Alloc> set_union(const set<Key, Compare, Alloc>& lhs, const set<Key, Compare, Alloc>& rhs)
+	{
+		set<Key, Compare, Alloc> res(lhs.key_comp(), lhs.get_allocator());
+		res._tree.assign_union(lhs._tree, rhs._tree);
+		return res;
+	}
+
+	template<class Key, class Compare, class Alloc>
+	set<Key, Compare, Alloc> set_intersection(const set<Key, Compare, Alloc>& lhs, const set<Key, Compare, Alloc>& rhs)
+	{
+		set<Key, Compare, Alloc> res(lhs.key_comp(), lhs.get_allocator());
+		res._tree.assign_intersection(lhs._tree, rhs._tree);
+		return res;
+	}
+
+	template<class Key, class Compare, class Alloc>
+	set<Key, Compare, Alloc> set_difference(const set<Key, Compare, Alloc>& lhs, const set<Key, Compare, Alloc>& rhs)
+	{
+		set<Key, Compare, Alloc> res(lhs.key_comp(), lhs.get_allocator());
+		res._tree.assign_difference(lhs._tree, rhs._tree);
+		return res;
+	}
+
+	template<class Key, class Compare, class Alloc>
+	set<Key, Compare, Alloc> set_symmetric_difference(const set<Key, Compare, Alloc>& lhs, const set<Key, Compare, Alloc>& rhs)
+	{
+		set<Key, Compare, Alloc> res(lhs.key_comp(), lhs.get_allocator());
+		res._tree.assign_symmetric_difference(lhs._tree, rhs._tree);
+		return res;
+	}
+
 	template<class Key,class Compare, class Alloc>
 	void swap(const ft::set<Key, Compare, Alloc>& lhs, const ft::set<Key, Compare, Alloc>& rhs)
 	{
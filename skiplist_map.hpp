@@ -0,0 +1,514 @@
+#ifndef SKIPLIST_MAP_HPP
+# define SKIPLIST_MAP_HPP
+
+# include <memory>
+# include <sched.h>
+# include "./tree/skiplist_node.hpp"
+# include "./iter/skiplist_iterator.hpp"
+# include "./utils/epoch.hpp"
+# include "./utils/utils.hpp"
+
+namespace ft
+{
+/*
+* Ordered map on a lock-free skip list, for many readers next to
+* concurrent writers. find, count, lower_bound, upper_bound, lookup and
+* iteration only load; insert links level 0 with a CAS, which is when
+* the element appears, then its upper levels; erase marks the node's
+* links and unlinks it (Harris/Fraser). Unlinked nodes are freed through
+* an epoch_domain once no operation can still see them.
+* Every member but clear, swap, assignment and destruction may run from
+* any number of threads at once. Iterators and references stay valid
+* while the thread holds a read_guard on the map; without one they are
+* only safe while no other thread erases.
+*/
+	template <class Key,
+				class T,
+				class Compare = std::less<Key>,
+				class Allocator = std::allocator<ft::pair<const Key, T> > >
+	class skiplist_map
+	{
+	public:
+		typedef				Key										key_type;
+		typedef				T										mapped_type;
+		typedef				ft::pair<const Key, T>					value_type;
+		typedef				Compare									key_compare;
+		typedef				Allocator								allocator_type;
+		typedef typename	Allocator::reference					reference;
+		typedef typename	Allocator::const_reference				const_reference;
+		typedef typename	Allocator::pointer						pointer;
+		typedef typename	Allocator::const_pointer				const_pointer;
+		typedef typename	Allocator::size_type					size_type;
+		typedef typename	Allocator::difference_type				difference_type;
+
+		typedef				skiplist_iterator<value_type>			iterator;
+		typedef				skiplist_iterator<const value_type>		const_iterator;
+
+		/* p = 1/2 per level: fewer hops than 1/4 for one more link per node on average */
+		enum { max_height = 32 };
+
+		/* keeps nodes this thread can reach from being freed */
+		class read_guard
+		{
+		private:
+			epoch_guard	_guard;
+
+		public:
+			explicit read_guard(const skiplist_map& m): _guard(m._epoch) {}
+		};
+
+		friend class read_guard;
+
+	private:
+		typedef				skiplist_node<value_type>				node_type;
+		typedef typename	node_type::link_type					link_type;
+		typedef typename	Allocator::template rebind<node_type>::other	node_allocator;
+
+		allocator_type			_alloc;
+		key_compare				_comp;
+		node_type*				_head;		/* max_height links, no value */
+		size_type				_size;
+		unsigned long long		_seed;
+		node_type*				_retired;	/* unlinked, waiting for their epoch */
+		size_type				_retired_count;
+		mutable epoch_domain	_epoch;
+
+	public:
+// construct/copy/destroy:
+		explicit skiplist_map(const Compare& comp = Compare(), const allocator_type& alloc = allocator_type()):
+			_alloc(alloc), _comp(comp), _head(_new_head()), _size(0), _seed(0), _retired(0), _retired_count(0)
+		{}
+
+		template <class InputIterator>
+		skiplist_map(InputIterator first, InputIterator last,
+				const Compare& comp = Compare(), const allocator_type& alloc = allocator_type()):
+			_alloc(alloc), _comp(comp), _head(_new_head()), _size(0), _seed(0), _retired(0), _retired_count(0)
+		{
+			try
+			{
+				insert(first, last);
+			}
+			catch (...)
+			{
+				_destroy();
+				throw ;
+			}
+		}
+
+		/* x must not be modified meanwhile */
+		skiplist_map(const skiplist_map& x):
+			_alloc(x._alloc), _comp(x._comp), _head(_new_head()), _size(0), _seed(0), _retired(0), _retired_count(0)
+		{
+			try
+			{
+				insert(x.begin(), x.end());
+			}
+			catch (...)
+			{
+				_destroy();
+				throw ;
+			}
+		}
+
+		skiplist_map& operator=(const skiplist_map& x)
+		{
+			if (&x == this)
+				return *this;
+			clear();
+			_comp = x._comp;
+			insert(x.begin(), x.end());
+			return *this;
+		}
+
+		~skiplist_map()
+		{
+			_destroy();
+		}
+
+		allocator_type get_allocator() const { return _alloc; }
+
+// iterators:
+		iterator begin() { return iterator(_first()); }
+		const_iterator begin() const { return const_iterator(_first()); }
+		iterator end() { return iterator(); }
+		const_iterator end() const { return const_iterator(); }
+
+// capacity:
+		bool empty() const { return size() == 0; }
+		size_type size() const { return __atomic_load_n(&_size, __ATOMIC_RELAXED); }
+		size_type max_size() const { return node_allocator(_alloc).max_size(); }
+
+// element access:
+		T& operator[](const key_type& k)
+		{
+			return insert(value_type(k, mapped_type())).first->second;
+		}
+
+// modifiers:
+		pair<iterator, bool> insert(const value_type& x)
+		{
+			epoch_guard guard(_epoch);
+			node_type* preds[max_height];
+			node_type* succs[max_height];
+			node_type* node = 0;
+			for (;;)
+			{
+				if (_find(x.first, preds, succs))
+				{
+					if (node)
+						_delete_node(node);
+					return ft::make_pair(iterator(succs[0]), false);
+				}
+				if (!node)
+					node = _new_node(x, _random_height());
+				for (unsigned l = 0; l < node->_height; ++l)
+					__atomic_store_n(&node->_next[l], node_type::make(succs[l]), __ATOMIC_RELAXED);
+				link_type expected = node_type::make(succs[0]);
+				if (__atomic_compare_exchange_n(&preds[0]->_next[0], &expected, node_type::make(node),
+							false, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+					break ;
+			}
+			__atomic_add_fetch(&_size, 1, __ATOMIC_RELAXED);
+			/* nobody else writes node->_next[l] before level l is linked */
+			for (unsigned l = 1; l < node->_height; ++l)
+				for (;;)
+				{
+					link_type expected = node_type::make(succs[l]);
+					if (__atomic_compare_exchange_n(&preds[l]->_next[l], &expected, node_type::make(node),
+								false, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+						break ;
+					_find(x.first, preds, succs);
+					__atomic_store_n(&node->_next[l], node_type::make(succs[l]), __ATOMIC_RELAXED);
+				}
+			__atomic_store_n(&node->_linked, 1, __ATOMIC_RELEASE);
+			return ft::make_pair(iterator(node), true);
+		}
+
+		template <class InputIterator>
+		void insert(InputIterator first, InputIterator last)
+		{
+			for (; first != last; ++first)
+				insert(value_type(*first));
+		}
+
+		void erase(iterator position)
+		{
+			erase(position->first);
+		}
+
+		size_type erase(const key_type& k)
+		{
+			epoch_guard guard(_epoch);
+			node_type* preds[max_height];
+			node_type* succs[max_height];
+			if (!_find(k, preds, succs))
+				return 0;
+			node_type* node = succs[0];
+			/* an insert still linking the upper levels would relink a retired node */
+			while (!__atomic_load_n(&node->_linked, __ATOMIC_ACQUIRE))
+				::sched_yield();
+			for (unsigned l = node->_height - 1; l > 0; --l)
+				_mark(node, l);
+			/* the thread that marks level 0 erased it */
+			link_type next = node->load(0);
+			do
+			{
+				if (node_type::marked(next))
+					return 0;
+			}
+			while (!__atomic_compare_exchange_n(&node->_next[0], &next, next | 1,
+						false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+			__atomic_sub_fetch(&_size, 1, __ATOMIC_RELAXED);
+			/* unlinks every marked node on the way down, this one included */
+			_find(k, preds, succs);
+			_retire(node);
+			return 1;
+		}
+
+		/* not concurrent: no other thread may use either map */
+		void swap(skiplist_map& x)
+		{
+			_reclaim_all();
+			x._reclaim_all();
+			std::swap(_alloc, x._alloc);
+			std::swap(_comp, x._comp);
+			std::swap(_head, x._head);
+			std::swap(_size, x._size);
+			std::swap(_seed, x._seed);
+		}
+
+		/* not concurrent */
+		void clear()
+		{
+			node_type* x = node_type::ptr(_head->_next[0]);
+			while (x)
+			{
+				node_type* next = node_type::ptr(x->_next[0]);
+				_delete_node(x);
+				x = next;
+			}
+			for (unsigned l = 0; l < max_height; ++l)
+				_head->_next[l] = 0;
+			_size = 0;
+			_reclaim_all();
+		}
+
+// observers:
+		key_compare key_comp() const { return _comp; }
+
+// operations:
+		iterator find(const key_type& k) { return iterator(_locate(k, false, true)); }
+		const_iterator find(const key_type& k) const { return const_iterator(_locate(k, false, true)); }
+		size_type count(const key_type& k) const { return _locate(k, false, true) ? 1 : 0; }
+
+		/* copies the mapped value out under the map's own guard */
+		bool lookup(const key_type& k, mapped_type& out) const
+		{
+			epoch_guard guard(_epoch);
+			node_type* x = _seek(k, false);
+			if (x && _comp(k, x->_value.first))
+				x = 0;
+			if (x)
+				out = x->_value.second;
+			return x != 0;
+		}
+
+		iterator lower_bound(const key_type& k) { return iterator(_locate(k, false, false)); }
+		const_iterator lower_bound(const key_type& k) const { return const_iterator(_locate(k, false, false)); }
+		iterator upper_bound(const key_type& k) { return iterator(_locate(k, true, false)); }
+		const_iterator upper_bound(const key_type& k) const { return const_iterator(_locate(k, true, false)); }
+
+		pair<iterator, iterator> equal_range(const key_type& k)
+		{
+			return ft::make_pair(lower_bound(k), upper_bound(k));
+		}
+
+		pair<const_iterator, const_iterator> equal_range(const key_type& k) const
+		{
+			return ft::make_pair(lower_bound(k), upper_bound(k));
+		}
+
+	private:
+		/* first live node not below k (upper: above k), 0 if none; loads only */
+		node_type* _seek(const key_type& k, bool upper) const
+		{
+			node_type* pred = _head;
+			node_type* curr = 0;
+			for (int l = max_height - 1; l >= 0; --l)
+			{
+				curr = node_type::ptr(pred->load(l));
+				while (curr)
+				{
+					link_type succ = curr->load(l);
+					if (!node_type::marked(succ))
+					{
+						if (upper ? _comp(k, curr->_value.first) : !_comp(curr->_value.first, k))
+							break ;
+						pred = curr;
+					}
+					curr = node_type::ptr(succ);
+				}
+			}
+			return curr;
+		}
+
+		/* _seek under a guard; exact: 0 unless the node holds k */
+		node_type* _locate(const key_type& k, bool upper, bool exact) const
+		{
+			epoch_guard guard(_epoch);
+			node_type* x = _seek(k, upper);
+			return exact && x && _comp(k, x->_value.first) ? 0 : x;
+		}
+
+		node_type* _first() const
+		{
+			epoch_guard guard(_epoch);
+			return _head->next_live();
+		}
+
+		/*
+		* Writer search: preds[l] and succs[l] around k on every level, with
+		* the deleted nodes met on the way unlinked. True if succs[0] holds k.
+		*/
+		bool _find(const key_type& k, node_type** preds, node_type** succs) const
+		{
+			for (;;)
+			{
+				node_type* pred = _head;
+				int l = max_height - 1;
+				for (; l >= 0; --l)
+				{
+					node_type* curr = node_type::ptr(pred->load(l));
+					while (curr)
+					{
+						link_type succ = curr->load(l);
+						if (node_type::marked(succ))
+						{
+							link_type expected = node_type::make(curr);
+							if (!__atomic_compare_exchange_n(&pred->_next[l], &expected, succ & ~link_type(1),
+										false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+								break ;
+							curr = node_type::ptr(succ);
+							continue ;
+						}
+						if (!_comp(curr->_value.first, k))
+							break ;
+						pred = curr;
+						curr = node_type::ptr(succ);
+					}
+					/* a failed unlink: pred itself was deleted, start over */
+					if (curr && node_type::marked(curr->load(l)))
+						break ;
+					preds[l] = pred;
+					succs[l] = curr;
+				}
+				if (l < 0)
+					return succs[0] && !_comp(k, succs[0]->_value.first);
+			}
+		}
+
+		static void _mark(node_type* node, unsigned l)
+		{
+			link_type next = node->load(l);
+			while (!node_type::marked(next)
+					&& !__atomic_compare_exchange_n(&node->_next[l], &next, next | 1,
+							false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+				;
+		}
+
+		unsigned _random_height()
+		{
+			unsigned long long x = __atomic_add_fetch(&_seed, 0x9e3779b97f4a7c15ULL, __ATOMIC_RELAXED);
+			x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+			x ^= x >> 31;
+			return 1 + __builtin_ctzll(x | (1ULL << (max_height - 1)));
+		}
+
+		/* towers are whole node_type units: the struct plus the extra links */
+		static size_type _units(unsigned height)
+		{
+			return 1 + ((height - 1) * sizeof(link_type) + sizeof(node_type) - 1) / sizeof(node_type);
+		}
+
+		node_type* _allocate(unsigned height)
+		{
+			node_type* x = node_allocator(_alloc).allocate(_units(height));
+			x->_height = height;
+			x->_linked = 0;
+			x->_retired = 0;
+			for (unsigned l = 0; l < height; ++l)
+				x->_next[l] = 0;
+			return x;
+		}
+
+		node_type* _new_head()
+		{
+			node_type* x = _allocate(max_height);
+			x->_linked = 1;
+			return x;
+		}
+
+		node_type* _new_node(const value_type& v, unsigned height)
+		{
+			node_type* x = _allocate(height);
+			try
+			{
+				_alloc.construct(&x->_value, v);
+			}
+			catch (...)
+			{
+				node_allocator(_alloc).deallocate(x, _units(height));
+				throw ;
+			}
+			return x;
+		}
+
+		void _delete_node(node_type* x)
+		{
+			_alloc.destroy(&x->_value);
+			node_allocator(_alloc).deallocate(x, _units(x->_height));
+		}
+
+		void _retire(node_type* node)
+		{
+			node->_retire_epoch = _epoch.current();
+			_push_retired(node, node);
+			if ((__atomic_add_fetch(&_retired_count, 1, __ATOMIC_RELAXED) & 63) == 0)
+				_reclaim();
+		}
+
+		void _push_retired(node_type* first, node_type* last)
+		{
+			node_type* old = __atomic_load_n(&_retired, __ATOMIC_RELAXED);
+			do
+				last->_retired = old;
+			while (!__atomic_compare_exchange_n(&_retired, &old, first,
+						true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+		}
+
+		/* frees what no operation can reach any more, puts the rest back */
+		void _reclaim()
+		{
+			unsigned long safe = _epoch.try_advance();
+			node_type* x = __atomic_exchange_n(&_retired, (node_type*)0, __ATOMIC_ACQUIRE);
+			node_type* keep = 0;
+			node_type* keep_last = 0;
+			while (x)
+			{
+				node_type* next = x->_retired;
+				if (x->_retire_epoch <= safe)
+					_delete_node(x);
+				else
+				{
+					x->_retired = keep;
+					keep = x;
+					if (!keep_last)
+						keep_last = x;
+				}
+				x = next;
+			}
+			if (keep)
+				_push_retired(keep, keep_last);
+		}
+
+		/* not concurrent: nothing is in flight */
+		void _reclaim_all()
+		{
+			node_type* x = _retired;
+			while (x)
+			{
+				node_type* next = x->_retired;
+				_delete_node(x);
+				x = next;
+			}
+			_retired = 0;
+		}
+
+		void _destroy()
+		{
+			clear();
+			node_allocator(_alloc).deallocate(_head, _units(max_height));
+		}
+	};
+
+	template <class Key, class T, class Compare, class Alloc>
+	bool operator==(const skiplist_map<Key, T, Compare, Alloc>& lhs, const skiplist_map<Key, T, Compare, Alloc>& rhs)
+	{
+		return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	template <class Key, class T, class Compare, class Alloc>
+	bool operator!=(const skiplist_map<Key, T, Compare, Alloc>& lhs, const skiplist_map<Key, T, Compare, Alloc>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <class Key, class T, class Compare, class Alloc>
+	void swap(skiplist_map<Key, T, Compare, Alloc>& lhs, skiplist_map<Key, T, Compare, Alloc>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+}
+
+#endif
@@ -0,0 +1,319 @@
+#ifndef STABLE_VECTOR_HPP
+# define STABLE_VECTOR_HPP
+
+# include <memory>
+# include <stdexcept>
+# include "./utils/utils.hpp"
+# include "./iter/iterator_stable_vector.hpp"
+# include "./iter/iterator_reverse.hpp"
+
+namespace ft
+{
+/*
+* Vector over chunks of 16, 32, 64... elements (stable_vector_chunks):
+* growing adds a chunk and never moves or copies an element, so pointers,
+* references and iterators stay valid until their element is popped.
+* operator[] finds the chunk from the highest bit of the index, one more
+* load than ft::vector. The chunk table is allocated once, at its full
+* size, with the first chunk. Grows and shrinks at the back only.
+*/
+	template <class T,
+				class Allocator = std::allocator<T> >
+	class stable_vector
+	{
+	public:
+		typedef				T												value_type;
+		typedef				Allocator										allocator_type;
+		typedef typename	Allocator::pointer								pointer;
+		typedef typename	Allocator::const_pointer						const_pointer;
+		typedef				std::size_t										size_type;
+		typedef typename	Allocator::reference							reference;
+		typedef typename	Allocator::const_reference						const_reference;
+		typedef				std::ptrdiff_t									difference_type;
+		typedef				ft::stable_vector_iterator<value_type>			iterator;
+		typedef				ft::stable_vector_iterator<const value_type>	const_iterator;
+		typedef				ft::reverse_iterator<iterator>					reverse_iterator;
+		typedef				ft::reverse_iterator<const_iterator>			const_reverse_iterator;
+	private:
+		typedef				stable_vector_chunks							chunks;
+		typedef typename	Allocator::template rebind<pointer>::other		allocator_table;
+
+		allocator_type	_alloc;
+		pointer*		_chunks;	/* chunks::max entries once allocated */
+		size_type		_nchunks;
+		size_type		_size;
+	public:
+//(1) empty container constructor (default constructor):
+		explicit stable_vector(const Allocator& alloc = Allocator()):
+			_alloc(alloc),
+			_chunks(t_nullptr),
+			_nchunks(0),
+			_size(0)
+		{}
+//(2) fill constructor:
+		explicit stable_vector(size_type n,
+						const value_type& value = value_type(),
+						const allocator_type& alloc = allocator_type()):
+			_alloc(alloc),
+			_chunks(t_nullptr),
+			_nchunks(0),
+			_size(0)
+		{
+			try
+			{
+				assign(n, value);
+			}
+			catch (...)
+			{
+				_release();
+				throw ;
+			}
+		}
+//(3) range constructor:
+		template <class InputIterator>
+		stable_vector(InputIterator first,
+				InputIterator last,
+				const allocator_type& alloc = allocator_type(),
+				typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type* = t_nullptr):
+			_alloc(alloc),
+			_chunks(t_nullptr),
+			_nchunks(0),
+			_size(0)
+		{
+			try
+			{
+				assign(first, last);
+			}
+			catch (...)
+			{
+				_release();
+				throw ;
+			}
+		}
+//(4) copy constructor:
+		stable_vector(const stable_vector& x):
+			_alloc(x._alloc),
+			_chunks(t_nullptr),
+			_nchunks(0),
+			_size(0)
+		{
+			try
+			{
+				assign(x.begin(), x.end());
+			}
+			catch (...)
+			{
+				_release();
+				throw ;
+			}
+		}
+//Destructor:
+		~stable_vector()
+		{
+			_release();
+		}
+//Assign content:
+		stable_vector& operator=(const stable_vector& x)
+		{
+			if (this != &x)
+				assign(x.begin(), x.end());
+			return *this;
+		}
+
+		/* keeps the chunks */
+		template <class InputIterator>
+		void assign(InputIterator first,
+					InputIterator last,
+					typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type* = t_nullptr)
+		{
+			clear();
+			for (; first != last; ++first)
+				push_back(*first);
+		}
+
+		void assign(size_type n, const T& u)
+		{
+			value_type copy(u);
+			clear();
+			reserve(n);
+			while (_size < n)
+				push_back(copy);
+		}
+
+//iterators:
+		iterator begin() { return iterator(_chunks, 0); }
+		const_iterator begin() const { return const_iterator(_chunks, 0); }
+		iterator end() { return iterator(_chunks, _size); }
+		const_iterator end() const { return const_iterator(_chunks, _size); }
+		reverse_iterator rbegin() { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+		reverse_iterator rend() { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+//capacity:
+		size_type size() const { return _size; }
+		size_type capacity() const { return chunks::total(_nchunks); }
+		size_type max_size() const { return _alloc.max_size(); }
+		bool empty() const { return _size == 0; }
+
+		/* heap bytes held: the chunks, unused capacity included, and the chunk table */
+		size_type memory_usage() const
+		{
+			return capacity() * sizeof(value_type) + (_chunks ? chunks::max * sizeof(pointer) : 0);
+		}
+
+		void resize(size_type sz, T c = T())
+		{
+			if (sz > max_size())
+				throw (std::length_error("stable_vector"));
+			while (_size > sz)
+				pop_back();
+			reserve(sz);
+			while (_size < sz)
+				push_back(c);
+		}
+
+		/* adds chunks, nothing moves */
+		void reserve(size_type n)
+		{
+			if (n > max_size())
+				throw (std::length_error("stable_vector"));
+			while (capacity() < n)
+				_add_chunk();
+		}
+
+//element access:
+		reference operator[](size_type n) { return chunks::at(_chunks, n); }
+		const_reference operator[](size_type n) const { return chunks::at(_chunks, n); }
+		reference front() { return _chunks[0][0]; }
+		const_reference front() const { return _chunks[0][0]; }
+		reference back() { return (*this)[_size - 1]; }
+		const_reference back() const { return (*this)[_size - 1]; }
+
+		reference at(size_type n)
+		{
+			if (n >= _size)
+				throw (std::out_of_range("stable_vector"));
+			return (*this)[n];
+		}
+
+		const_reference at(size_type n) const
+		{
+			if (n >= _size)
+				throw (std::out_of_range("stable_vector"));
+			return (*this)[n];
+		}
+
+//Modifiers:
+		void push_back(const value_type& value)
+		{
+			if (_size == capacity())
+				_add_chunk();
+			_alloc.construct(&(*this)[_size], value);
+			++_size;
+		}
+
+		void pop_back()
+		{
+			--_size;
+			_alloc.destroy(&(*this)[_size]);
+		}
+
+		void swap(stable_vector& x)
+		{
+			allocator_type save_alloc = x._alloc;
+			pointer* save_chunks = x._chunks;
+			size_type save_nchunks = x._nchunks;
+			size_type save_size = x._size;
+			x._alloc = _alloc;
+			x._chunks = _chunks;
+			x._nchunks = _nchunks;
+			x._size = _size;
+			_alloc = save_alloc;
+			_chunks = save_chunks;
+			_nchunks = save_nchunks;
+			_size = save_size;
+		}
+
+		/* keeps the chunks */
+		void clear()
+		{
+			if (ft::is_trivially_destructible<value_type>::value)
+			{
+				_size = 0;
+				return ;
+			}
+			while (_size)
+				pop_back();
+		}
+
+//Non-member function overloads
+		friend bool operator==(const stable_vector& x, const stable_vector& y)
+		{
+			if (x.size() != y.size())
+				return false;
+			return ft::equal(x.begin(), x.end(), y.begin());
+		}
+
+		friend bool operator!=(const stable_vector& x, const stable_vector& y)
+		{
+			return (!(x == y));
+		}
+
+		friend bool operator< (const stable_vector& x, const stable_vector& y)
+		{
+			return ft::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end());
+		}
+
+		friend bool operator> (const stable_vector& x, const stable_vector& y)
+		{
+			return (y < x);
+		}
+
+		friend bool operator<=(const stable_vector& x, const stable_vector& y)
+		{
+			return !(y < x);
+		}
+
+		friend bool operator>=(const stable_vector& x, const stable_vector& y)
+		{
+			return !(x < y);
+		}
+
+	private:
+		void _add_chunk()
+		{
+			if (_nchunks == size_type(chunks::max))
+				throw (std::length_error("stable_vector"));
+			if (_chunks == t_nullptr)
+			{
+				allocator_table alloc_table(_alloc);
+				_chunks = alloc_table.allocate(chunks::max);
+			}
+			_chunks[_nchunks] = _alloc.allocate(chunks::size(_nchunks));
+			++_nchunks;
+		}
+
+		void _release()
+		{
+			clear();
+			for (size_type k = 0; k < _nchunks; ++k)
+				_alloc.deallocate(_chunks[k], chunks::size(k));
+			if (_chunks)
+			{
+				allocator_table alloc_table(_alloc);
+				alloc_table.deallocate(_chunks, chunks::max);
+			}
+			_chunks = t_nullptr;
+			_nchunks = 0;
+		}
+	};
+
+	template <class T, class Allocator>
+	void swap(stable_vector<T,Allocator>& x, stable_vector<T,Allocator>& y)
+	{
+		x.swap(y);
+	}
+}
+
+#endif
@@ -0,0 +1,332 @@
+#ifndef STATIC_VECTOR_HPP
+# define STATIC_VECTOR_HPP
+
+# include <new>
+# include <stdexcept>
+# include <algorithm>
+# include "./utils/utils.hpp"
+# include "./iter/iterator_random_access.hpp"
+# include "./iter/iterator_reverse.hpp"
+
+namespace ft
+{
+/*
+* ft::vector with the N elements stored inside the object: no allocator,
+* no heap, capacity() is always N. Going past N throws length_error
+* before anything is modified. clear() of a trivially destructible T
+* only resets the size. Usable as the Container of ft::stack.
+*/
+	template <class T, std::size_t N>
+	class static_vector
+	{
+	public:
+		typedef				T											value_type;
+		typedef				T*											pointer;
+		typedef				const T*									const_pointer;
+		typedef				T&											reference;
+		typedef				const T&									const_reference;
+		typedef				std::size_t									size_type;
+		typedef				std::ptrdiff_t								difference_type;
+		typedef				ft::random_access_iterator<pointer>			iterator;
+		typedef				ft::random_access_iterator<const_pointer>	const_iterator;
+		typedef				ft::reverse_iterator<iterator>				reverse_iterator;
+		typedef				ft::reverse_iterator<const_iterator>		const_reverse_iterator;
+
+	private:
+		/* aligned for T; without the GCC/clang attribute, for any scalar */
+# if defined(__GNUC__) || defined(__clang__)
+		struct _storage
+		{
+			char		_bytes[N * sizeof(T)] __attribute__((aligned(__alignof__(T))));
+		};
+# else
+		union _storage
+		{
+			char		_bytes[N * sizeof(T)];
+			long double	_align_ld;
+			long long	_align_ll;
+			void*		_align_p;
+		};
+# endif
+
+		size_type	_size;
+		_storage	_buf;
+
+	public:
+//(1) empty container constructor (default constructor):
+		static_vector(): _size(0) {}
+//(2) fill constructor:
+		explicit static_vector(size_type n, const value_type& value = value_type()): _size(0)
+		{
+			assign(n, value);
+		}
+//(3) range constructor:
+		template <class InputIterator>
+		static_vector(InputIterator first,
+				InputIterator last,
+				typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type* = t_nullptr): _size(0)
+		{
+			assign(first, last);
+		}
+//(4) copy constructor:
+		static_vector(const static_vector& x): _size(0)
+		{
+			_append(x.begin(), x.end());
+		}
+//Destructor:
+		~static_vector()
+		{
+			clear();
+		}
+//Assign content:
+		static_vector& operator=(const static_vector& x)
+		{
+			if (this != &x)
+			{
+				clear();
+				_append(x.begin(), x.end());
+			}
+			return *this;
+		}
+
+		template <class InputIterator>
+		void assign(InputIterator first,
+					InputIterator last,
+					typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type* = t_nullptr)
+		{
+			_check(ft::distance(first, last));
+			clear();
+			_append(first, last);
+		}
+
+		void assign(size_type n, const T& u)
+		{
+			_check(n);
+			value_type copy(u);
+			clear();
+			while (_size < n)
+				_construct(_data() + _size, copy);
+		}
+
+//iterators:
+		iterator begin() { return iterator(_data()); }
+		const_iterator begin() const { return const_iterator(_data()); }
+		iterator end() { return iterator(_data() + _size); }
+		const_iterator end() const { return const_iterator(_data() + _size); }
+		reverse_iterator rbegin() { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+		reverse_iterator rend() { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+//capacity:
+		size_type size() const { return _size; }
+		size_type capacity() const { return N; }
+		size_type max_size() const { return N; }
+		/* heap bytes held: none */
+		size_type memory_usage() const { return 0; }
+		bool empty() const { return _size == 0; }
+		bool full() const { return _size == N; }
+
+		void resize(size_type sz, T c = T())
+		{
+			_check(sz);
+			if (sz < _size)
+				_destroy(_data() + sz, _data() + _size);
+			while (_size < sz)
+				_construct(_data() + _size, c);
+		}
+
+		/* storage is fixed: only checks n */
+		void reserve(size_type n)
+		{
+			_check(n);
+		}
+
+//element access:
+		reference operator[](size_type n) { return _data()[n]; }
+		const_reference operator[](size_type n) const { return _data()[n]; }
+		reference front() { return *_data(); }
+		const_reference front() const { return *_data(); }
+		reference back() { return _data()[_size - 1]; }
+		const_reference back() const { return _data()[_size - 1]; }
+
+		reference at(size_type n)
+		{
+			if (n >= _size)
+				throw (std::out_of_range("static_vector"));
+			return _data()[n];
+		}
+
+		const_reference at(size_type n) const
+		{
+			if (n >= _size)
+				throw (std::out_of_range("static_vector"));
+			return _data()[n];
+		}
+
+		pointer data() { return _data(); }
+		const_pointer data() const { return _data(); }
+
+//Modifiers:
+		void push_back(const value_type& value)
+		{
+			_check(_size + 1);
+			_construct(_data() + _size, value);
+		}
+
+		void pop_back()
+		{
+			_destroy(_data() + _size - 1, _data() + _size);
+		}
+
+		iterator insert(iterator position, const T& x)
+		{
+			size_type i = position - begin();
+			insert(position, 1, x);
+			return begin() + i;
+		}
+
+		void insert(iterator position, size_type n, const T& x)
+		{
+			_check(_size + n);
+			value_type copy(x);
+			pointer pos = _open(position, n);
+			for (size_type i = 0; i < n; ++i)
+				::new (static_cast<void*>(pos + i)) value_type(copy);
+			_size += n;
+		}
+
+		template <class InputIterator>
+		void insert(iterator position,
+					InputIterator first,
+					InputIterator last,
+					typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type* = t_nullptr)
+		{
+			size_type n = ft::distance(first, last);
+			_check(_size + n);
+			pointer pos = _open(position, n);
+			for (size_type i = 0; i < n; ++i)
+				::new (static_cast<void*>(pos + i)) value_type(*first++);
+			_size += n;
+		}
+
+		iterator erase(iterator position)
+		{
+			return erase(position, position + 1);
+		}
+
+		iterator erase(iterator first, iterator last)
+		{
+			pointer f = &*first;
+			pointer l = f + (last - first);
+			pointer end = _data() + _size;
+			std::copy(l, end, f);
+			_destroy(end - (l - f), end);
+			return first;
+		}
+
+		/* O(N): the elements themselves change places */
+		void swap(static_vector& x)
+		{
+			static_vector& small = _size < x._size ? *this : x;
+			static_vector& large = _size < x._size ? x : *this;
+			size_type common = small._size;
+			std::swap_ranges(small._data(), small._data() + common, large._data());
+			small._append(large._data() + common, large._data() + large._size);
+			large._destroy(large._data() + common, large._data() + large._size);
+		}
+
+		void clear()
+		{
+			_destroy(_data(), _data() + _size);
+		}
+
+//Non-member function overloads
+		friend bool operator==(const static_vector& x, const static_vector& y)
+		{
+			if (x.size() != y.size())
+				return false;
+			return ft::equal(x.begin(), x.end(), y.begin());
+		}
+
+		friend bool operator!=(const static_vector& x, const static_vector& y)
+		{
+			return (!(x == y));
+		}
+
+		friend bool operator< (const static_vector& x, const static_vector& y)
+		{
+			return ft::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end());
+		}
+
+		friend bool operator> (const static_vector& x, const static_vector& y)
+		{
+			return (y < x);
+		}
+
+		friend bool operator<=(const static_vector& x, const static_vector& y)
+		{
+			return !(y < x);
+		}
+
+		friend bool operator>=(const static_vector& x, const static_vector& y)
+		{
+			return !(x < y);
+		}
+
+	private:
+		pointer _data() { return reinterpret_cast<pointer>(_buf._bytes); }
+		const_pointer _data() const { return reinterpret_cast<const_pointer>(_buf._bytes); }
+
+		static void _check(size_type n)
+		{
+			if (n > N)
+				throw (std::length_error("static_vector"));
+		}
+
+		/* p is the end, the size grows once T's copy succeeded */
+		void _construct(pointer p, const value_type& value)
+		{
+			::new (static_cast<void*>(p)) value_type(value);
+			++_size;
+		}
+
+		/* [first, last) is the tail */
+		void _destroy(pointer first, pointer last)
+		{
+			if (!ft::is_trivially_destructible<value_type>::value)
+				for (pointer p = first; p != last; ++p)
+					p->~value_type();
+			_size -= last - first;
+		}
+
+		template <class InputIterator>
+		void _append(InputIterator first, InputIterator last)
+		{
+			for (; first != last; ++first)
+				_construct(_data() + _size, *first);
+		}
+
+		/* moves [position, end) n slots up and returns the raw gap, capacity was checked */
+		pointer _open(iterator position, size_type n)
+		{
+			pointer pos = &*position;
+			if (n == 0)
+				return pos;
+			for (pointer p = _data() + _size; p != pos; --p)
+			{
+				::new (static_cast<void*>(p - 1 + n)) value_type(*(p - 1));
+				(p - 1)->~value_type();
+			}
+			return pos;
+		}
+	};
+
+	template <class T, std::size_t N>
+	void swap(static_vector<T, N>& x, static_vector<T, N>& y)
+	{
+		x.swap(y);
+	}
+}
+
+#endif
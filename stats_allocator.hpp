@@ -0,0 +1,215 @@
+#ifndef STATS_ALLOCATOR_HPP
+# define STATS_ALLOCATOR_HPP
+
+# include <memory>
+# include <cstddef>
+# include <ostream>
+# include "./utils/utils.hpp"
+
+namespace ft
+{
+	/* counters summed over all threads, histogram[i] counts sizes in [2^i, 2^(i+1)) */
+	struct alloc_counters
+	{
+		enum { bucket_count = sizeof(std::size_t) * 8 };
+
+		std::size_t	allocations;
+		std::size_t	deallocations;
+		std::size_t	bytes_allocated;
+		std::size_t	bytes_freed;
+		std::size_t	bytes_live;
+		std::size_t	peak_bytes;
+		std::size_t	histogram[bucket_count];
+	};
+
+/*
+* Allocation counters shared by every stats_allocator with the same Tag.
+* Each thread writes only its own block (relaxed atomic load + store, no
+* read-modify-write, no lock). Blocks are linked into a list once and
+* never freed, snapshot() sums them. bytes_live is exact once
+* threads are quiescent; peak_bytes is exact for a single thread and the
+* sum of per-thread peaks (an upper bound) otherwise.
+* Uses the GCC/clang __thread and __atomic extensions.
+*/
+	template <class Tag = void>
+	class alloc_stats
+	{
+	private:
+		struct block
+		{
+			block*			_next;
+			std::size_t		_allocations;
+			std::size_t		_deallocations;
+			std::size_t		_bytes_allocated;
+			std::size_t		_bytes_freed;
+			std::ptrdiff_t	_live;
+			std::ptrdiff_t	_peak;
+			std::size_t		_histogram[alloc_counters::bucket_count];
+		};
+
+		static block*				_blocks;
+		static __thread block*		_local;
+
+	public:
+		static void on_allocate(std::size_t bytes)
+		{
+			block* b = _get();
+			_bump(b->_allocations, 1);
+			_bump(b->_bytes_allocated, bytes);
+			_bump(b->_histogram[_bucket(bytes)], 1);
+			std::ptrdiff_t live = __atomic_load_n(&b->_live, __ATOMIC_RELAXED) + std::ptrdiff_t(bytes);
+			__atomic_store_n(&b->_live, live, __ATOMIC_RELAXED);
+			if (live > __atomic_load_n(&b->_peak, __ATOMIC_RELAXED))
+				__atomic_store_n(&b->_peak, live, __ATOMIC_RELAXED);
+		}
+
+		static void on_deallocate(std::size_t bytes)
+		{
+			block* b = _get();
+			_bump(b->_deallocations, 1);
+			_bump(b->_bytes_freed, bytes);
+			std::ptrdiff_t live = __atomic_load_n(&b->_live, __ATOMIC_RELAXED) - std::ptrdiff_t(bytes);
+			__atomic_store_n(&b->_live, live, __ATOMIC_RELAXED);
+		}
+
+		static alloc_counters snapshot()
+		{
+			alloc_counters c = alloc_counters();
+			std::ptrdiff_t live = 0;
+			for (block* b = __atomic_load_n(&_blocks, __ATOMIC_ACQUIRE); b; b = b->_next)
+			{
+				c.allocations += __atomic_load_n(&b->_allocations, __ATOMIC_RELAXED);
+				c.deallocations += __atomic_load_n(&b->_deallocations, __ATOMIC_RELAXED);
+				c.bytes_allocated += __atomic_load_n(&b->_bytes_allocated, __ATOMIC_RELAXED);
+				c.bytes_freed += __atomic_load_n(&b->_bytes_freed, __ATOMIC_RELAXED);
+				live += __atomic_load_n(&b->_live, __ATOMIC_RELAXED);
+				c.peak_bytes += __atomic_load_n(&b->_peak, __ATOMIC_RELAXED);
+				for (int i = 0; i < alloc_counters::bucket_count; i++)
+					c.histogram[i] += __atomic_load_n(&b->_histogram[i], __ATOMIC_RELAXED);
+			}
+			c.bytes_live = live > 0 ? live : 0;
+			return c;
+		}
+
+		static void dump(std::ostream& os, const char* name = "alloc_stats")
+		{
+			alloc_counters c = snapshot();
+			os << name << ": allocations " << c.allocations
+				<< " deallocations " << c.deallocations
+				<< " bytes_allocated " << c.bytes_allocated
+				<< " bytes_freed " << c.bytes_freed
+				<< " bytes_live " << c.bytes_live
+				<< " peak_bytes " << c.peak_bytes << '\n';
+			for (int i = 0; i < alloc_counters::bucket_count; i++)
+				if (c.histogram[i])
+					os << "  [" << (std::size_t(1) << i) << ", " << (std::size_t(1) << i) * 2
+						<< ") " << c.histogram[i] << '\n';
+		}
+
+	private:
+		static void _bump(std::size_t& counter, std::size_t n)
+		{
+			__atomic_store_n(&counter, __atomic_load_n(&counter, __ATOMIC_RELAXED) + n, __ATOMIC_RELAXED);
+		}
+
+		static int _bucket(std::size_t bytes)
+		{
+			int i = 0;
+			while (bytes >>= 1)
+				++i;
+			return i;
+		}
+
+		static block* _get()
+		{
+			if (_local)
+				return _local;
+			block* b = new block();
+			b->_next = __atomic_load_n(&_blocks, __ATOMIC_RELAXED);
+			while (!__atomic_compare_exchange_n(&_blocks, &b->_next, b,
+						true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+				;
+			_local = b;
+			return b;
+		}
+	};
+
+	template <class Tag>
+	typename alloc_stats<Tag>::block* alloc_stats<Tag>::_blocks = 0;
+
+	template <class Tag>
+	__thread typename alloc_stats<Tag>::block* alloc_stats<Tag>::_local = 0;
+
+/*
+* Forwards to Inner and reports every non-empty allocate/deallocate to
+* alloc_stats<Tag>. Give each container family its own Tag to split the
+* numbers; memory_usage() on the containers gives per-instance bytes.
+*/
+	template <class T,
+				class Inner = std::allocator<T>,
+				class Tag = void>
+	class stats_allocator
+	{
+	public:
+		typedef typename	Inner::template rebind<T>::other		inner_type;
+		typedef				T										value_type;
+		typedef typename	inner_type::pointer						pointer;
+		typedef typename	inner_type::const_pointer				const_pointer;
+		typedef typename	inner_type::reference					reference;
+		typedef typename	inner_type::const_reference				const_reference;
+		typedef typename	inner_type::size_type					size_type;
+		typedef typename	inner_type::difference_type				difference_type;
+		typedef				alloc_stats<Tag>						stats_type;
+
+		template <class U>
+		struct rebind
+		{
+			typedef stats_allocator<U, typename Inner::template rebind<U>::other, Tag> other;
+		};
+
+	private:
+		inner_type	_inner;
+
+	public:
+		stats_allocator(): _inner() {}
+		stats_allocator(const Inner& inner): _inner(inner) {}
+
+		template <class U, class I>
+		stats_allocator(const stats_allocator<U, I, Tag>& x): _inner(x.inner()) {}
+
+		const inner_type& inner() const { return _inner; }
+
+		pointer address(reference x) const { return _inner.address(x); }
+		const_pointer address(const_reference x) const { return _inner.address(x); }
+		size_type max_size() const { return _inner.max_size(); }
+
+		pointer allocate(size_type n, const void* hint = 0)
+		{
+			pointer p = _inner.allocate(n, hint);
+			if (n)
+				stats_type::on_allocate(n * sizeof(T));
+			return p;
+		}
+
+		void deallocate(pointer p, size_type n)
+		{
+			if (n)
+				stats_type::on_deallocate(n * sizeof(T));
+			_inner.deallocate(p, n);
+		}
+
+		void construct(pointer p, const T& x) { _inner.construct(p, x); }
+		void destroy(pointer p) { _inner.destroy(p); }
+	};
+
+	template <class T, class I, class U, class J, class Tag>
+	bool operator==(const stats_allocator<T, I, Tag>& x, const stats_allocator<U, J, Tag>& y) { return x.inner() == y.inner(); }
+
+	template <class T, class I, class U, class J, class Tag>
+	bool operator!=(const stats_allocator<T, I, Tag>& x, const stats_allocator<U, J, Tag>& y) { return !(x == y); }
+
+	template <class T, class Inner, class Tag>
+	struct is_monotonic_allocator<stats_allocator<T, Inner, Tag> > : public is_monotonic_allocator<Inner> {};
+}
+
+#endif
@@ -0,0 +1,705 @@
+#ifndef STRING_HPP
+# define STRING_HPP
+
+# include <memory>
+# include <cstring>
+# include <ostream>
+# include <stdexcept>
+# include "./utils/utils.hpp"
+# include "./utils/hash.hpp"
+# include "./iter/iterator_random_access.hpp"
+# include "./iter/iterator_reverse.hpp"
+
+namespace ft
+{
+/*
+* Byte string in three words. Up to sso_capacity (23 on 64-bit) chars
+* live in the object itself: the last byte holds sso_capacity - size, so
+* it is also the terminator of a full short string. Longer strings keep
+* pointer, size and capacity; the capacity word sets the top bit of that
+* same last byte. The size is stored, never scanned for, and ordering is
+* memcmp-based; key_prefix exposes the first 8 bytes as one word, which
+* the RBTree descents compare before the full key. Iterators are plain char pointers into data().
+*/
+	template <class Allocator = std::allocator<char> >
+	class basic_string
+	{
+	public:
+		typedef				char										value_type;
+		typedef				Allocator									allocator_type;
+		typedef typename	Allocator::pointer							pointer;
+		typedef typename	Allocator::const_pointer					const_pointer;
+		typedef typename	Allocator::reference						reference;
+		typedef typename	Allocator::const_reference					const_reference;
+		typedef				std::size_t									size_type;
+		typedef				std::ptrdiff_t								difference_type;
+		typedef				ft::random_access_iterator<char*>			iterator;
+		typedef				ft::random_access_iterator<const char*>		const_iterator;
+		typedef				ft::reverse_iterator<iterator>				reverse_iterator;
+		typedef				ft::reverse_iterator<const_iterator>		const_reverse_iterator;
+
+		static const size_type	npos = static_cast<size_type>(-1);
+
+	private:
+		struct _long_rep
+		{
+			char*		_ptr;
+			size_type	_size;
+			size_type	_cap;		/* through _cap_word() */
+		};
+
+		enum { tag = sizeof(_long_rep) - 1 };
+
+		union _rep
+		{
+			_long_rep	_l;
+			char		_s[sizeof(_long_rep)];
+		};
+
+		/* derives from the allocator so a stateless one takes no room */
+		struct _impl: public Allocator
+		{
+			_rep	_r;
+
+			explicit _impl(const Allocator& alloc): Allocator(alloc) {}
+		};
+
+		_impl	_m;
+
+	public:
+		enum { sso_capacity = tag };
+
+// construct/copy/destroy:
+		explicit basic_string(const allocator_type& alloc = allocator_type()): _m(alloc)
+		{
+			_set_short_size(0);
+		}
+
+		basic_string(const basic_string& str): _m(str._m)
+		{
+			_init(str.data(), str.size());
+		}
+
+		basic_string(const basic_string& str, size_type pos, size_type n = npos,
+				const allocator_type& alloc = allocator_type()): _m(alloc)
+		{
+			str._check_pos(pos);
+			_init(str.data() + pos, _clamp(n, str.size() - pos));
+		}
+
+		basic_string(const char* s, size_type n, const allocator_type& alloc = allocator_type()): _m(alloc)
+		{
+			_init(s, n);
+		}
+
+		basic_string(const char* s, const allocator_type& alloc = allocator_type()): _m(alloc)
+		{
+			_init(s, std::strlen(s));
+		}
+
+		basic_string(size_type n, char c, const allocator_type& alloc = allocator_type()): _m(alloc)
+		{
+			_init(NULL, n);
+			std::memset(_data(), c, n);
+		}
+
+		template <class InputIterator>
+		basic_string(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type(),
+				typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type* = t_nullptr): _m(alloc)
+		{
+			_set_short_size(0);
+			try
+			{
+				append(first, last);
+			}
+			catch (...)
+			{
+				_free();
+				throw ;
+			}
+		}
+
+		~basic_string()
+		{
+			_free();
+		}
+
+		basic_string& operator=(const basic_string& str)
+		{
+			if (this != &str)
+				assign(str.data(), str.size());
+			return *this;
+		}
+
+		basic_string& operator=(const char* s) { return assign(s, std::strlen(s)); }
+
+		basic_string& operator=(char c) { return assign(&c, 1); }
+
+		allocator_type get_allocator() const { return _m; }
+
+// iterators:
+		iterator begin() { return iterator(_data()); }
+		const_iterator begin() const { return const_iterator(data()); }
+		iterator end() { return iterator(_data() + size()); }
+		const_iterator end() const { return const_iterator(data() + size()); }
+		reverse_iterator rbegin() { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+		reverse_iterator rend() { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+// capacity:
+		size_type size() const { return _is_long() ? _m._r._l._size : size_type(tag - _last_byte()); }
+		size_type length() const { return size(); }
+		size_type max_size() const { return (npos >> 8) - 1; }
+		size_type capacity() const { return _is_long() ? _cap_of(_m._r._l._cap) : size_type(sso_capacity); }
+		bool empty() const { return size() == 0; }
+		/* heap bytes held, 0 while the string is short */
+		size_type memory_usage() const { return _is_long() ? capacity() + 1 : 0; }
+
+		void reserve(size_type n = 0)
+		{
+			if (n > capacity())
+				_reallocate(n);
+		}
+
+		void resize(size_type n, char c = char())
+		{
+			size_type len = size();
+			if (n > len)
+				append(n - len, c);
+			else
+				_set_size(n);
+		}
+
+		void clear() { _set_size(0); }
+
+// element access:
+		reference operator[](size_type pos) { return _data()[pos]; }
+		const_reference operator[](size_type pos) const { return data()[pos]; }
+
+		reference at(size_type pos)
+		{
+			if (pos >= size())
+				throw std::out_of_range("basic_string");
+			return _data()[pos];
+		}
+
+		const_reference at(size_type pos) const
+		{
+			if (pos >= size())
+				throw std::out_of_range("basic_string");
+			return data()[pos];
+		}
+
+		reference front() { return _data()[0]; }
+		const_reference front() const { return data()[0]; }
+		reference back() { return _data()[size() - 1]; }
+		const_reference back() const { return data()[size() - 1]; }
+
+		const char* data() const { return _is_long() ? _m._r._l._ptr : _m._r._s; }
+		const char* c_str() const { return data(); }
+
+// modifiers:
+		basic_string& append(const char* s, size_type n)
+		{
+			size_type len = size();
+			if (n > max_size() - len)
+				throw std::length_error("basic_string");
+			if (len + n > capacity())
+			{
+				/* s may point into this string: copy it before the old buffer goes */
+				size_type cap = _grow(len + n);
+				char* p = _allocate(cap);
+				std::memcpy(p, data(), len);
+				std::memcpy(p + len, s, n);
+				_free();
+				_set_long(p, len + n, cap);
+			}
+			else
+				std::memcpy(_data() + len, s, n);
+			_set_size(len + n);
+			return *this;
+		}
+
+		basic_string& append(const basic_string& str) { return append(str.data(), str.size()); }
+
+		basic_string& append(const basic_string& str, size_type pos, size_type n = npos)
+		{
+			str._check_pos(pos);
+			return append(str.data() + pos, _clamp(n, str.size() - pos));
+		}
+
+		basic_string& append(const char* s) { return append(s, std::strlen(s)); }
+
+		basic_string& append(size_type n, char c)
+		{
+			size_type len = size();
+			if (n > max_size() - len)
+				throw std::length_error("basic_string");
+			reserve(len + n > capacity() ? _grow(len + n) : 0);
+			std::memset(_data() + len, c, n);
+			_set_size(len + n);
+			return *this;
+		}
+
+		template <class InputIterator>
+		typename ft::enable_if<!ft::is_integral<InputIterator>::value, basic_string&>::type
+			append(InputIterator first, InputIterator last)
+		{
+			for (; first != last; ++first)
+				push_back(*first);
+			return *this;
+		}
+
+		basic_string& operator+=(const basic_string& str) { return append(str.data(), str.size()); }
+		basic_string& operator+=(const char* s) { return append(s, std::strlen(s)); }
+		basic_string& operator+=(char c) { push_back(c); return *this; }
+
+		void push_back(char c)
+		{
+			size_type len = size();
+			if (len == capacity())
+				_reallocate(_grow(len + 1));
+			_data()[len] = c;
+			_set_size(len + 1);
+		}
+
+		void pop_back() { _set_size(size() - 1); }
+
+		basic_string& assign(const char* s, size_type n)
+		{
+			if (n > capacity())
+			{
+				char* p = _allocate(n);
+				std::memcpy(p, s, n);
+				_free();
+				_set_long(p, n, n);
+			}
+			else
+				std::memmove(_data(), s, n);
+			_set_size(n);
+			return *this;
+		}
+
+		basic_string& assign(const basic_string& str) { return *this = str; }
+		basic_string& assign(const char* s) { return assign(s, std::strlen(s)); }
+
+		basic_string& assign(size_type n, char c)
+		{
+			clear();
+			return append(n, c);
+		}
+
+		template <class InputIterator>
+		typename ft::enable_if<!ft::is_integral<InputIterator>::value, basic_string&>::type
+			assign(InputIterator first, InputIterator last)
+		{
+			basic_string tmp(first, last, get_allocator());
+			swap(tmp);
+			return *this;
+		}
+
+		basic_string& insert(size_type pos, const char* s, size_type n) { return replace(pos, 0, s, n); }
+		basic_string& insert(size_type pos, const char* s) { return replace(pos, 0, s, std::strlen(s)); }
+		basic_string& insert(size_type pos, const basic_string& str) { return replace(pos, 0, str.data(), str.size()); }
+
+		basic_string& insert(size_type pos, size_type n, char c)
+		{
+			_check_pos(pos);
+			_make_gap(pos, 0, n);
+			std::memset(_data() + pos, c, n);
+			return *this;
+		}
+
+		iterator insert(iterator p, char c)
+		{
+			size_type pos = p - begin();
+			insert(pos, 1, c);
+			return begin() + pos;
+		}
+
+		basic_string& erase(size_type pos = 0, size_type n = npos)
+		{
+			_check_pos(pos);
+			_make_gap(pos, _clamp(n, size() - pos), 0);
+			return *this;
+		}
+
+		iterator erase(iterator p)
+		{
+			size_type pos = p - begin();
+			_make_gap(pos, 1, 0);
+			return begin() + pos;
+		}
+
+		iterator erase(iterator first, iterator last)
+		{
+			size_type pos = first - begin();
+			_make_gap(pos, last - first, 0);
+			return begin() + pos;
+		}
+
+		basic_string& replace(size_type pos, size_type len, const char* s, size_type n)
+		{
+			_check_pos(pos);
+			len = _clamp(len, size() - pos);
+			const char* d = data();
+			if (s + n > d && s < d + size())
+			{
+				/* s points into this string, which the gap moves */
+				basic_string tmp(s, n, get_allocator());
+				return replace(pos, len, tmp.data(), n);
+			}
+			_make_gap(pos, len, n);
+			std::memcpy(_data() + pos, s, n);
+			return *this;
+		}
+
+		basic_string& replace(size_type pos, size_type len, const basic_string& str)
+		{
+			return replace(pos, len, str.data(), str.size());
+		}
+
+		basic_string& replace(size_type pos, size_type len, const char* s)
+		{
+			return replace(pos, len, s, std::strlen(s));
+		}
+
+		size_type copy(char* s, size_type n, size_type pos = 0) const
+		{
+			_check_pos(pos);
+			n = _clamp(n, size() - pos);
+			std::memcpy(s, data() + pos, n);
+			return n;
+		}
+
+		/* no pointer into either string refers to the object itself, so bytes can be swapped */
+		void swap(basic_string& str)
+		{
+			_impl tmp = _m;
+			_m = str._m;
+			str._m = tmp;
+		}
+
+// operations:
+		basic_string substr(size_type pos = 0, size_type n = npos) const
+		{
+			return basic_string(*this, pos, n, get_allocator());
+		}
+
+		size_type find(const char* s, size_type pos, size_type n) const
+		{
+			size_type len = size();
+			if (pos > len || n > len - pos)
+				return npos;
+			if (n == 0)
+				return pos;
+			const char* d = data();
+			const char* last = d + len - n + 1;
+			for (const char* p = d + pos; p < last; ++p)
+			{
+				p = static_cast<const char*>(std::memchr(p, s[0], last - p));
+				if (p == NULL)
+					return npos;
+				if (std::memcmp(p + 1, s + 1, n - 1) == 0)
+					return p - d;
+			}
+			return npos;
+		}
+
+		size_type find(const basic_string& str, size_type pos = 0) const { return find(str.data(), pos, str.size()); }
+		size_type find(const char* s, size_type pos = 0) const { return find(s, pos, std::strlen(s)); }
+
+		size_type find(char c, size_type pos = 0) const
+		{
+			size_type len = size();
+			if (pos >= len)
+				return npos;
+			const char* d = data();
+			const char* p = static_cast<const char*>(std::memchr(d + pos, c, len - pos));
+			return p == NULL ? npos : size_type(p - d);
+		}
+
+		size_type rfind(const char* s, size_type pos, size_type n) const
+		{
+			size_type len = size();
+			if (n > len)
+				return npos;
+			pos = pos < len - n ? pos : len - n;
+			const char* d = data();
+			for (size_type i = pos + 1; i-- > 0; )
+				if (std::memcmp(d + i, s, n) == 0)
+					return i;
+			return npos;
+		}
+
+		size_type rfind(const basic_string& str, size_type pos = npos) const { return rfind(str.data(), pos, str.size()); }
+		size_type rfind(const char* s, size_type pos = npos) const { return rfind(s, pos, std::strlen(s)); }
+		size_type rfind(char c, size_type pos = npos) const { return rfind(&c, pos, 1); }
+
+		int compare(const basic_string& str) const { return _compare(data(), size(), str.data(), str.size()); }
+		int compare(const char* s) const { return _compare(data(), size(), s, std::strlen(s)); }
+
+		int compare(size_type pos, size_type len, const basic_string& str) const
+		{
+			_check_pos(pos);
+			return _compare(data() + pos, _clamp(len, size() - pos), str.data(), str.size());
+		}
+
+	private:
+		/* negative, 0 or positive like memcmp, shorter first on a tie */
+		static int _compare(const char* a, size_type na, const char* b, size_type nb)
+		{
+			int r = std::memcmp(a, b, na < nb ? na : nb);
+			if (r != 0)
+				return r;
+			return na < nb ? -1 : na > nb;
+		}
+
+		unsigned char _last_byte() const { return static_cast<unsigned char>(_m._r._s[tag]); }
+
+		bool _is_long() const { return (_last_byte() & 0x80) != 0; }
+
+		char* _data() { return _is_long() ? _m._r._l._ptr : _m._r._s; }
+
+/*
+* The capacity word of a long string carries the long flag in the byte
+* the short string keeps its tag in: the top bit on little-endian, the
+* low byte on big-endian targets.
+*/
+# if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		static size_type _cap_word(size_type cap) { return (cap << 8) | 0x80; }
+		static size_type _cap_of(size_type word) { return word >> 8; }
+# else
+		static size_type _cap_word(size_type cap) { return cap | ~(npos >> 1); }
+		static size_type _cap_of(size_type word) { return word & (npos >> 1); }
+# endif
+
+		void _set_short_size(size_type n)
+		{
+			_m._r._s[n] = '\0';
+			_m._r._s[tag] = static_cast<char>(tag - n);
+		}
+
+		void _set_long(char* p, size_type n, size_type cap)
+		{
+			_m._r._l._ptr = p;
+			_m._r._l._size = n;
+			_m._r._l._cap = _cap_word(cap);
+		}
+
+		/* n <= capacity(), terminates */
+		void _set_size(size_type n)
+		{
+			if (_is_long())
+			{
+				_m._r._l._size = n;
+				_m._r._l._ptr[n] = '\0';
+			}
+			else
+				_set_short_size(n);
+		}
+
+		static size_type _clamp(size_type n, size_type left) { return n < left ? n : left; }
+
+		void _check_pos(size_type pos) const
+		{
+			if (pos > size())
+				throw std::out_of_range("basic_string");
+		}
+
+		/* doubles, so that appending one char at a time stays amortized O(1) */
+		size_type _grow(size_type n) const
+		{
+			size_type cap = capacity();
+			if (cap > max_size() / 2)
+				return max_size();
+			return n > 2 * cap ? n : 2 * cap;
+		}
+
+		char* _allocate(size_type cap)
+		{
+			if (cap > max_size())
+				throw std::length_error("basic_string");
+			return _m.allocate(cap + 1);
+		}
+
+		void _free()
+		{
+			if (_is_long())
+				_m.deallocate(_m._r._l._ptr, _cap_of(_m._r._l._cap) + 1);
+		}
+
+		/* s may be NULL: the n chars are left for the caller to write */
+		void _init(const char* s, size_type n)
+		{
+			if (n <= size_type(sso_capacity))
+			{
+				if (s != NULL)
+					std::memcpy(_m._r._s, s, n);
+				_set_short_size(n);
+				return ;
+			}
+			char* p = _allocate(n);
+			if (s != NULL)
+				std::memcpy(p, s, n);
+			p[n] = '\0';
+			_set_long(p, n, n);
+		}
+
+		/* cap > size() */
+		void _reallocate(size_type cap)
+		{
+			size_type len = size();
+			char* p = _allocate(cap);
+			std::memcpy(p, data(), len + 1);
+			_free();
+			_set_long(p, len, cap);
+		}
+
+		/* replaces [pos, pos + len) with n chars the caller writes */
+		void _make_gap(size_type pos, size_type len, size_type n)
+		{
+			size_type old = size();
+			size_type tail = old - pos - len;
+			if (n > len && n - len > max_size() - old)
+				throw std::length_error("basic_string");
+			size_type new_size = old - len + n;
+			if (new_size > capacity())
+			{
+				size_type cap = _grow(new_size);
+				char* p = _allocate(cap);
+				std::memcpy(p, data(), pos);
+				std::memcpy(p + pos + n, data() + pos + len, tail);
+				_free();
+				_set_long(p, new_size, cap);
+			}
+			else
+			{
+				char* d = _data();
+				std::memmove(d + pos + n, d + pos + len, tail);
+			}
+			_set_size(new_size);
+		}
+	};
+
+	template <class Allocator>
+	const typename basic_string<Allocator>::size_type basic_string<Allocator>::npos;
+
+	typedef basic_string<>	string;
+
+	/* RBTree descents over ft::string keys mostly settle on this one word; short strings keep it in the node */
+	template <class Allocator>
+	struct key_prefix<basic_string<Allocator> >
+	{
+		enum { enabled = 1 };
+
+		typedef unsigned long long	type;
+
+		/* the first 8 chars, big-endian, zero past the end: a heap buffer has at least 24 bytes too */
+		static type get(const basic_string<Allocator>& x)
+		{
+			type w;
+			std::memcpy(&w, x.data(), sizeof(w));
+# if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ != __ORDER_BIG_ENDIAN__
+			w = __builtin_bswap64(w);
+# endif
+			std::size_t n = x.size();
+			if (n < sizeof(w))
+				w &= n == 0 ? 0 : ~type(0) << (8 * (sizeof(w) - n));
+			return w;
+		}
+	};
+
+	template <class A>
+	bool operator==(const basic_string<A>& lhs, const basic_string<A>& rhs)
+	{
+		return lhs.size() == rhs.size() && std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+	}
+
+	template <class A>
+	bool operator==(const basic_string<A>& lhs, const char* rhs) { return lhs.compare(rhs) == 0; }
+
+	template <class A>
+	bool operator==(const char* lhs, const basic_string<A>& rhs) { return rhs.compare(lhs) == 0; }
+
+	template <class A>
+	bool operator!=(const basic_string<A>& lhs, const basic_string<A>& rhs) { return !(lhs == rhs); }
+
+	template <class A>
+	bool operator!=(const basic_string<A>& lhs, const char* rhs) { return !(lhs == rhs); }
+
+	template <class A>
+	bool operator!=(const char* lhs, const basic_string<A>& rhs) { return !(lhs == rhs); }
+
+	template <class A>
+	bool operator<(const basic_string<A>& lhs, const basic_string<A>& rhs) { return lhs.compare(rhs) < 0; }
+
+	template <class A>
+	bool operator<(const basic_string<A>& lhs, const char* rhs) { return lhs.compare(rhs) < 0; }
+
+	template <class A>
+	bool operator<(const char* lhs, const basic_string<A>& rhs) { return rhs.compare(lhs) > 0; }
+
+	template <class A>
+	bool operator<=(const basic_string<A>& lhs, const basic_string<A>& rhs) { return !(rhs < lhs); }
+
+	template <class A>
+	bool operator>(const basic_string<A>& lhs, const basic_string<A>& rhs) { return rhs < lhs; }
+
+	template <class A>
+	bool operator>=(const basic_string<A>& lhs, const basic_string<A>& rhs) { return !(lhs < rhs); }
+
+	template <class A>
+	basic_string<A> operator+(const basic_string<A>& lhs, const basic_string<A>& rhs)
+	{
+		basic_string<A> r(lhs);
+		return r.append(rhs);
+	}
+
+	template <class A>
+	basic_string<A> operator+(const basic_string<A>& lhs, const char* rhs)
+	{
+		basic_string<A> r(lhs);
+		return r.append(rhs);
+	}
+
+	template <class A>
+	basic_string<A> operator+(const char* lhs, const basic_string<A>& rhs)
+	{
+		basic_string<A> r(lhs, rhs.get_allocator());
+		return r.append(rhs);
+	}
+
+	template <class A>
+	basic_string<A> operator+(const basic_string<A>& lhs, char rhs)
+	{
+		basic_string<A> r(lhs);
+		r.push_back(rhs);
+		return r;
+	}
+
+	template <class A>
+	void swap(basic_string<A>& x, basic_string<A>& y) { x.swap(y); }
+
+	template <class A>
+	std::ostream& operator<<(std::ostream& os, const basic_string<A>& str)
+	{
+		return os.write(str.data(), str.size());
+	}
+
+	/* FNV-1a, like hash<std::string> */
+	template <class A>
+	struct hash<basic_string<A> >
+	{
+		std::size_t operator()(const basic_string<A>& s) const
+		{
+			unsigned long long h = 0xcbf29ce484222325ULL;
+			for (std::size_t i = 0; i < s.size(); ++i)
+				h = (h ^ static_cast<unsigned char>(s[i])) * 0x100000001b3ULL;
+			return hash_mix(h);
+		}
+	};
+}
+
+#endif
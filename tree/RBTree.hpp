@@ -5,18 +5,60 @@
 # include <iostream>
 # include "../iter/iterator_reverse.hpp"
 # include "../iter/RBTree_iterator.hpp"
+# include "RBTree_node_handle.hpp"
 # include "../utils/utils.hpp"
+# include "../vector.hpp"
+# include "../utils/parallel.hpp"
+
+/*
+* -DFT_RBTREE_TELEMETRY: every tree counts its comparator calls, rotations
+* and recolorings (relaxed atomic adds, so concurrent finds stay safe);
+* telemetry() returns them with the current depth profile. Off by default,
+* the counting then compiles to nothing.
+*/
+# ifdef FT_RBTREE_TELEMETRY
+#  define FT_RBTREE_COUNT(counter, n) __atomic_fetch_add(&_counters.counter, (n), __ATOMIC_RELAXED)
+# else
+#  define FT_RBTREE_COUNT(counter, n) ((void)0)
+# endif
 
 namespace ft
 {
+	/* snapshot of one tree: counters since construction or reset_telemetry(), depths as of now */
+	struct rbtree_telemetry
+	{
+		unsigned long	comparisons;
+		unsigned long	rotations;
+		unsigned long	recolors;
+		std::size_t		max_depth;		/* nodes on the longest root-to-leaf path */
+		double			average_depth;	/* over all nodes, the root has depth 1 */
+	};
+
+/*
+* Augmentation policy: update(x, nil, comp) recomputes a field stored in
+* x->_value from x and its children. The tree calls it on both nodes of
+* every rotation and on the path to the root after each insert, erase and
+* bulk build, so the field always describes the whole subtree.
+*/
+	struct rbtree_no_augment
+	{
+		enum { enabled = 0 };
+
+		template<class Node, class Compare>
+		static void update(Node*, const Node*, const Compare&) {}
+	};
+
 	template<class Value, 
 				class Compare = std::less<Value>,
-				class Allocator = std::allocator<Value> >
+				class Allocator = std::allocator<Value>,
+				class Augment = rbtree_no_augment>
 	class RBTree
 	{
 	public:
 		typedef				Value											value_type;
 		typedef				Compare											value_compare;
+		typedef				ft::compare_prefix<Compare>						prefix;
+		typedef typename	prefix::type									prefix_type;
 		typedef				Allocator										allocator_type;
 		typedef typename	allocator_type::reference						reference;
 		typedef typename	allocator_type::const_reference					const_reference;
@@ -32,6 +74,7 @@ namespace ft
 		typedef				ft::RBTree_iterator<const Value>				const_iterator;
 		typedef				ft::reverse_iterator<iterator>					reverse_iterator;
 		typedef				ft::reverse_iterator<const_iterator>			const_reverse_iterator;
+		typedef				ft::RBTree_node_handle<Value, Allocator>		node_type;
 
 	public:
 		allocator_node	_alloc_node;
@@ -41,17 +84,31 @@ namespace ft
 		value_compare	_comp;
 		size_t			_size;
 
+	private:
+# ifdef FT_RBTREE_TELEMETRY
+		struct _telemetry_counters
+		{
+			unsigned long	comparisons;
+			unsigned long	rotations;
+			unsigned long	recolors;
+
+			_telemetry_counters(): comparisons(0), rotations(0), recolors(0) {}
+		};
+
+		mutable _telemetry_counters	_counters;
+# endif
+
 	public:
 // construct/copy/destroy:	
 		RBTree(const Compare &comp, const allocator_type& alloc = allocator_type()):
-			_alloc_node(allocator_node()),
+			_alloc_node(alloc),
 			_alloc_value(alloc),
 			_nil(_alloc_node.allocate(1)),
 			_root(_nil),
 			_comp(comp),
 			_size(0)
 		{
-			_alloc_node.construct(_nil, Node(_nil, _nil, _nil, nil));
+			_init_nil();
 		}
 
 		RBTree():
@@ -62,15 +119,17 @@ namespace ft
 			_comp(value_compare()),
 			_size(0)
 		{
-			_alloc_node.construct(_nil, Node(_nil, _nil, _nil, nil));
+			_init_nil();
 		}
 
 		RBTree(const RBTree& src):
+			_alloc_node(src._alloc_node),
+			_alloc_value(src._alloc_value),
 			_nil(_alloc_node.allocate(1)),
 			_root(_nil),
 			 _comp(src._comp)
 		{
-			_alloc_node.construct(_nil, Node(_nil, _nil, _nil, nil));
+			_init_nil();
 			*this = src;
 		}
 
@@ -79,7 +138,6 @@ namespace ft
 				return *this;
 
 			clear_node(_root);
-			_alloc_node.destroy(_nil);
 			_alloc_node.deallocate(_nil, 1);
 	
 			_alloc_node = src._alloc_node;
@@ -87,7 +145,7 @@ namespace ft
 			_comp = src._comp;
 
 			_nil = _alloc_node.allocate(1);
-			_alloc_node.construct(_nil, *(src._nil));
+			_init_nil();
 			_root = _nil;
 
 			//for (const_iterator it = src.begin(); it != src.end(); it++)
@@ -96,8 +154,10 @@ namespace ft
 			if (src._size > 0)
 			{
 				_root = copy_node(src._root);
-				_root->_parent = _nil;
+				_root->set_parent(_nil);
 				copy_all(_root, src._root);
+				_nil->set_parent(tree_max(_root));
+				_thread_all();
 			}
 			_size = src._size;
 	
@@ -106,31 +166,24 @@ namespace ft
 
 		node_pointer copy_node(node_pointer other)
 		{
-			node_pointer new_node = _alloc_node.allocate(1);
-			_alloc_node.construct(new_node, Node(other->_parent, other->_left, other->_right, other->_type));
-			if (other->_value)
-			{
-				new_node->_value = _alloc_value.allocate(1);
-				_alloc_value.construct(new_node->_value, *other->_value);
-			}
-			return (new_node);
+			return (_create_node(other->_value, _nil, other->type()));
 		}
 
 		void	copy_all(node_pointer my_node, node_pointer other){				
-			if (other->_left->_type == nil)
+			if (other->_left->is_nil())
 				my_node->_left = _nil;
 			else 
 			{
 				my_node->_left = copy_node(other->_left);
-				my_node->_left->_parent = my_node;
+				my_node->_left->set_parent(my_node);
 				copy_all(my_node->_left, other->_left);
 			}
-			if (other->_right->_type == nil)
+			if (other->_right->is_nil())
 				my_node->_right = _nil;
 			else
 			{
 				my_node->_right = copy_node(other->_right);
-				my_node->_right->_parent = my_node;
+				my_node->_right->set_parent(my_node);
 				copy_all(my_node->_right, other->_right);
 			}
 		}
@@ -160,125 +213,112 @@ namespace ft
 		bool empty() const { return _size == 0; }
 		size_type size() const { return _size; }
 		size_type max_size() const { return (_alloc_value.max_size()); }
+		/* heap bytes held: every node with its links, and the sentinel */
+		size_type memory_usage() const { return (_size + 1) * sizeof(Node); }
 
 // modifiers:
 		ft::pair<node_pointer, bool> insert(value_type const &value)
 		{
-//http://algolist.manual.ru/ds/rbtree.php
-			node_pointer current, parent, x;
-			current = _root;
-			parent = _nil;
-
-			while (current != _nil)
-			{
-				parent = current;
-				if (_comp(value, *(parent->_value)))
-					current = current->_left;
-				else if (_comp(*(parent->_value), value))
-					current = current->_right;
-				else
-					return ft::pair<node_pointer, bool>(current, false);
-			}
-
-			pointer new_val = _alloc_value.allocate(1);
-		 	_alloc_value.construct(new_val, value);
-
-			x = _alloc_node.allocate(1);
-			_alloc_node.construct(x, Node(parent, _nil, _nil, red, new_val));
-			
-			if (parent != _nil)
-			{		
-				if (_comp(value, *(parent->_value)))
-					parent->_left = x;
-				else
-					parent->_right = x;
-			}
-			else
-			{		
-				_root = x;
-				_nil->_parent = x;
-			}
-
-			_nil->_parent = tree_max(_root);
-			_insertFixup(x);
-			++_size;
-			return ft::pair<node_pointer, bool>(x, true);		
+			FT_PERF_SCOPE("RBTree::insert");
+			node_pointer parent;
+			bool left;
+			node_pointer found = _descend(value, parent, left);
+			if (found != _nil)
+				return ft::pair<node_pointer, bool>(found, false);
+
+			node_pointer x = _create_node(value, parent, red);
+			_link(x, parent, left);
+			return ft::pair<node_pointer, bool>(x, true);
 		}
 
 		bool erase(const value_type& value)
 		{
+			FT_PERF_SCOPE("RBTree::erase");
 			node_pointer pos = _search(value, _root);
 			if (pos == _nil) 
 				return false;
-//http://algolist.manual.ru/ds/rbtree.php
-			/*****************************
-			*  delete node z from tree  *
-			*****************************/
-			node_pointer x, y;
+			_detach(pos);
+			_destroy_node(pos);
+			return true;		
+		}
 
-			if (pos->_left == _nil || pos->_right == _nil) 
-			{		
-				/* y has a NIL node as a child */
-				y = pos;
-			}
-			else 
-			{
-				/* find tree successor with a NIL node as a child */
-				y = pos->_right;
-				while (y->_left != _nil) 
-					y = y->_left;
-			}
+// node handles (allocators of both trees must compare equal):
+		node_type extract(iterator position)
+		{
+			node_pointer pos = position.node();
+			_detach(pos);
+			pos->init(NULL, NULL, NULL, black);
+			return node_type(pos, _alloc_value);
+		}
 
-			/* x is y's only child */
-			if (y->_left != _nil)
-				x = y->_left;
-			else
-				x = y->_right;
+		node_type extract(const value_type& value)
+		{
+			node_pointer pos = _search(value, _root);
+			if (pos == _nil)
+				return node_type();
+			return extract(iterator(pos));
+		}
 
-			/* remove y from the parent chain */
-			if (x != _nil)
-				x->_parent = y->_parent;
-			if (y->_parent != _nil)
-				if (y == y->_parent->_left)
-					y->_parent->_left = x;
-				else
-					y->_parent->_right = x;
-			else
-				_root = x;
+		ft::pair<node_pointer, bool> insert(node_type& nh)
+		{
+			if (nh.empty())
+				return ft::pair<node_pointer, bool>(_nil, false);
+
+			node_pointer parent;
+			bool left;
+			node_pointer found = _descend(nh.value(), parent, left);
+			if (found != _nil)
+				return ft::pair<node_pointer, bool>(found, false);
+
+			node_pointer x = nh.release();
+			x->init(parent, _nil, _nil, red);
+			_link(x, parent, left);
+			return ft::pair<node_pointer, bool>(x, true);
+		}
 
-			if (y != pos)
-			{
-				_alloc_value.destroy(pos->_value);
-				_alloc_value.deallocate(pos->_value, 1);
-				pos->_value = y->_value;
-			}
-			else
+		void merge(RBTree& source)
+		{
+			if (this == &source)
+				return ;
+			iterator it = source.begin();
+			iterator last = source.end();
+			while (it != last)
 			{
-				_alloc_value.destroy(y->_value);
-				_alloc_value.deallocate(y->_value, 1);
+				iterator next = it;
+				++next;
+				node_pointer parent;
+				bool left;
+				/* the slot stays valid: extracting only rebalances source */
+				if (_descend(*it, parent, left) == _nil)
+				{
+					node_pointer x = it.node();
+					source._detach(x);
+					x->init(parent, _nil, _nil, red);
+					_link(x, parent, left);
+				}
+				it = next;
 			}
-
-			_alloc_node.destroy(y);
-			_alloc_node.deallocate(y, 1);
-
-			_nil->_parent = tree_max(_root);
-			_deleteFixup(x);
-			_size--;
-			return true;		
 		}
 
+		/* the allocators go with the nodes: a stateful one (arena_allocator) owns them */
 		void swap(RBTree &other)
 		{
+			allocator_node tmpAllocNode = _alloc_node;
+			allocator_type tmpAllocValue = _alloc_value;
 			node_pointer tmpNil = _nil;
 			node_pointer tmpHead = _root;
 			Compare tmpCmp = _comp;
 			size_t tmpSize = _size;
 
+			_alloc_node = other._alloc_node;
+			_alloc_value = other._alloc_value;
 			_nil  = other._nil;
 			_root = other._root;
 			_comp = other._comp;
 			_size = other._size;
 
+			other._alloc_node = tmpAllocNode;
+			other._alloc_value = tmpAllocValue;
 			other._nil  = tmpNil;
 			other._root = tmpHead;
 			other._comp = tmpCmp;
@@ -289,26 +329,122 @@ namespace ft
 		{
 			clear_node(_root);
 			_root = _nil;
-			_nil->_parent = _nil;
+			_init_nil();
 			_size = 0;
 		}
 
 // observers:
 		value_compare value_comp() const { return _comp; }
 
+		/* counters are 0 without FT_RBTREE_TELEMETRY; the depths cost an O(n) walk */
+		rbtree_telemetry telemetry() const
+		{
+			rbtree_telemetry t = rbtree_telemetry();
+# ifdef FT_RBTREE_TELEMETRY
+			t.comparisons = __atomic_load_n(&_counters.comparisons, __ATOMIC_RELAXED);
+			t.rotations = __atomic_load_n(&_counters.rotations, __ATOMIC_RELAXED);
+			t.recolors = __atomic_load_n(&_counters.recolors, __ATOMIC_RELAXED);
+# endif
+			std::size_t total = 0;
+			_depths(_root, 1, total, t.max_depth);
+			t.average_depth = _size ? double(total) / double(_size) : 0.0;
+			return t;
+		}
+
+		void reset_telemetry()
+		{
+# ifdef FT_RBTREE_TELEMETRY
+			__atomic_store_n(&_counters.comparisons, 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&_counters.rotations, 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&_counters.recolors, 0, __ATOMIC_RELAXED);
+# endif
+		}
+
 // operations:
+		enum { find_batch_size = 8 };
+
 		iterator find(const value_type& value)
 		{
+			FT_PERF_SCOPE("RBTree::find");
 			node_pointer find_res = _search(value, _root);
 			return (find_res == NULL ? end() : iterator(find_res));
 		}
 
 		const_iterator find(const value_type& value) const
 		{
+			FT_PERF_SCOPE("RBTree::find");
 			node_pointer find_res = _search(value, _root);
 			return (find_res == NULL ? end() : const_iterator(find_res));
 		}
 
+		/*
+		* Up to find_batch lookups descend in lockstep, one level each per
+		* round, so the prefetched child of one lookup loads while the
+		* others compare. Writes one iterator per value to out.
+		*/
+		template<class OutputIt>
+		OutputIt find_batch(const value_type* values, size_type n, OutputIt out)
+		{
+			node_pointer cur[find_batch_size];
+			node_pointer res[find_batch_size];
+			prefix_type words[find_batch_size];
+			while (n > 0)
+			{
+				size_type count = n < size_type(find_batch_size) ? n : size_type(find_batch_size);
+				for (size_type i = 0; i < count; ++i)
+				{
+					cur[i] = _root;
+					res[i] = _nil;
+					words[i] = prefix::get(values[i]);
+				}
+				size_type active = count;
+				while (active > 0)
+				{
+					active = 0;
+					for (size_type i = 0; i < count; ++i)
+					{
+						node_pointer node = cur[i];
+						if (node == _nil)
+							continue ;
+						if (_less(values[i], words[i], node))
+							node = node->_left;
+						else
+						{
+							res[i] = node;
+							node = node->_right;
+						}
+						FT_PREFETCH(node);
+						cur[i] = node;
+						active += (node != _nil);
+					}
+				}
+				for (size_type i = 0; i < count; ++i)
+				{
+					if (res[i] != _nil && _less(res[i], values[i], words[i]))
+						res[i] = _nil;
+					*out++ = iterator(res[i]);
+				}
+				values += count;
+				n -= count;
+			}
+			return out;
+		}
+
+		template<class InputIt, class OutputIt>
+		OutputIt find_many(InputIt first, InputIt last, OutputIt out)
+		{
+			ft::vector<value_type> batch;
+			batch.reserve(find_batch_size);
+			while (first != last)
+			{
+				batch.clear();
+				while (first != last && batch.size() < size_type(find_batch_size))
+					batch.push_back(*first++);
+				out = find_batch(batch.data(), batch.size(), out);
+			}
+			return out;
+		}
+
 		size_type count(const value_type& value) const
 		{
 			return (find(value) != end());
@@ -316,38 +452,22 @@ namespace ft
 
 		iterator lower_bound(const value_type& value)
 		{
-			iterator last = end();
-			for (iterator first = begin(); first != last; ++first)
-				if(!_comp(*first, value))
-					return (first);
-			return (last);
+			return (iterator(_lower_bound(value)));
 		}
 
 		const_iterator lower_bound(const value_type& value) const
 		{
-			const_iterator last = end();
-			for (const_iterator first = begin(); first != last; ++first)
-				if(!_comp(*first, value))
-					return (first);
-			return (last);
+			return (const_iterator(_lower_bound(value)));
 		}
 
 		iterator upper_bound(const value_type& value)
 		{
-			iterator last = end();
-			for (iterator first = begin(); first != last; ++first)
-				if(_comp(value, *first))
-					return (first);
-			return (last);
+			return (iterator(_upper_bound(value)));
 		}
 
 		const_iterator upper_bound(const value_type& value) const
 		{
-			const_iterator last = end();
-			for (const_iterator first = begin(); first != last; ++first)
-				if(_comp(value, *first))
-					return (first);
-			return (last);
+			return (const_iterator(_upper_bound(value)));
 		}
 
 		ft::pair<iterator, iterator> equal_range(const value_type &value)
@@ -360,7 +480,415 @@ namespace ft
 			return (ft::make_pair(lower_bound(value), upper_bound(value)));
 		}
 
+// set algebra (merge walk + linear bulk build, result replaces *this):
+		void assign_union(const RBTree& lhs, const RBTree& rhs)
+		{
+			_merge_assign(lhs, rhs, only_lhs | both | only_rhs);
+		}
+
+		void assign_intersection(const RBTree& lhs, const RBTree& rhs)
+		{
+			_merge_assign(lhs, rhs, both);
+		}
+
+		void assign_difference(const RBTree& lhs, const RBTree& rhs)
+		{
+			_merge_assign(lhs, rhs, only_lhs);
+		}
+
+		void assign_symmetric_difference(const RBTree& lhs, const RBTree& rhs)
+		{
+			_merge_assign(lhs, rhs, only_lhs | only_rhs);
+		}
+
+		/* bulk load of a sorted, duplicate-free random-access range in O(n), replaces the content */
+		template <class RandomIt>
+		void assign_sorted(RandomIt first, RandomIt last)
+		{
+			RBTree tmp(_comp, _alloc_value);
+			tmp._build_sorted(_iterator_getter<RandomIt>(first), last - first);
+			swap(tmp);
+		}
+
+		/* same, subtrees below the top levels are built on `threads` threads: the allocator must be
+		   thread-safe (std::allocator is); a throw frees the partial tree and comes back through parallel_for */
+		template <class RandomIt>
+		void assign_sorted(RandomIt first, RandomIt last, unsigned threads)
+		{
+			RBTree tmp(_comp, _alloc_value);
+			tmp._build_sorted(_iterator_getter<RandomIt>(first), last - first, threads);
+			swap(tmp);
+		}
+
+		/* same as assign_sorted, value i is get(i) */
+		template <class Getter>
+		void assign_sorted_by(const Getter& get, size_type n)
+		{
+			RBTree tmp(_comp, _alloc_value);
+			tmp._build_sorted(get, n);
+			swap(tmp);
+		}
+
+	private:
+		enum merge_mode
+		{
+			only_lhs = 1,
+			both = 2,
+			only_rhs = 4
+		};
+
+		void _merge_assign(const RBTree& lhs, const RBTree& rhs, int mode)
+		{
+			ft::vector<const_pointer> buf;
+			buf.reserve(lhs._size + rhs._size);
+
+			const_iterator first1 = lhs.begin();
+			const_iterator last1 = lhs.end();
+			const_iterator first2 = rhs.begin();
+			const_iterator last2 = rhs.end();
+			while (first1 != last1 && first2 != last2)
+			{
+				if (_less(*first1, *first2))
+				{
+					if (mode & only_lhs)
+						buf.push_back(&(*first1));
+					++first1;
+				}
+				else if (_less(*first2, *first1))
+				{
+					if (mode & only_rhs)
+						buf.push_back(&(*first2));
+					++first2;
+				}
+				else
+				{
+					if (mode & both)
+						buf.push_back(&(*first1));
+					++first1;
+					++first2;
+				}
+			}
+			if (mode & only_lhs)
+				for (; first1 != last1; ++first1)
+					buf.push_back(&(*first1));
+			if (mode & only_rhs)
+				for (; first2 != last2; ++first2)
+					buf.push_back(&(*first2));
+
+			/* lhs or rhs may be *this: build aside, then swap in */
+			RBTree tmp(_comp, _alloc_value);
+			tmp._build_sorted(_pointer_getter(buf.data()), buf.size());
+			swap(tmp);
+		}
+
+		struct _pointer_getter
+		{
+			const const_pointer*	_values;
+
+			_pointer_getter(const const_pointer* values): _values(values) {}
+			const value_type& operator()(size_type i) const { return *_values[i]; }
+		};
+
+		template <class RandomIt>
+		struct _iterator_getter
+		{
+			RandomIt	_first;
+
+			_iterator_getter(RandomIt first): _first(first) {}
+			value_type operator()(size_type i) const { return value_type(_first[i]); }
+		};
+
+		/* subtree [first, last) still to build under parent, into *slot */
+		struct _build_task
+		{
+			size_type		_first;
+			size_type		_last;
+			node_pointer	_parent;
+			size_type		_depth;
+			node_pointer*	_slot;
+		};
+
+		template <class Getter>
+		struct _build_job
+		{
+			RBTree*				_tree;
+			const Getter*		_get;
+			const _build_task*	_tasks;
+			size_type			_red_depth;
+
+			void operator()(std::size_t i)
+			{
+				const _build_task& t = _tasks[i];
+				_tree->_build_node(*_get, t._first, t._last, t._parent, t._depth, _red_depth, t._slot);
+			}
+		};
+
+		/*
+		* get(0) < get(1) < ... < get(n - 1), tree must be empty. Every node
+		* is linked into its parent before its children are built, so when a
+		* copy throws the partial tree is reachable from _root and cleared.
+		*/
+		template <class Getter>
+		void _build_sorted(const Getter& get, size_type n, unsigned threads = 1)
+		{
+			if (n == 0)
+				return ;
+			/* nodes on the deepest level are red unless the tree is perfect */
+			size_type red_depth = 0;
+			while ((size_type(2) << red_depth) <= n)
+				++red_depth;
+			if (((n + 1) & n) == 0)
+				red_depth = n;
+			try
+			{
+				if (threads > 1 && n >= 65536)
+				{
+					/* about 4 subtrees per thread so uneven halves still balance */
+					size_type split_depth = 0;
+					while ((size_type(1) << split_depth) < size_type(threads) * 4)
+						++split_depth;
+					ft::vector<_build_task> tasks;
+					_build_top(get, 0, n, _nil, 0, red_depth, split_depth, &_root, tasks);
+					_build_job<Getter> job = { this, &get, tasks.data(), red_depth };
+					ft::parallel_for(tasks.size(), job, threads);
+				}
+				else
+					_build_node(get, 0, n, _nil, 0, red_depth, &_root);
+			}
+			catch (...)
+			{
+				clear();
+				throw ;
+			}
+			_nil->set_parent(tree_max(_root));
+			_thread_all();
+			_augment_all(_root);
+			_size = n;
+		}
+
+		/* *slot is _nil on entry, children are built after x is stored there */
+		template <class Getter>
+		void _build_node(const Getter& get, size_type first, size_type last,
+							node_pointer parent, size_type depth, size_type red_depth, node_pointer* slot)
+		{
+			if (first == last)
+				return ;
+			size_type mid = first + (last - first) / 2;
+
+			node_pointer x = _create_node(get(mid), parent, depth == red_depth ? red : black);
+			*slot = x;
+			_build_node(get, first, mid, x, depth + 1, red_depth, &x->_left);
+			_build_node(get, mid + 1, last, x, depth + 1, red_depth, &x->_right);
+		}
+
+		/* levels above split_depth are built here, the rest is queued */
+		template <class Getter>
+		void _build_top(const Getter& get, size_type first, size_type last, node_pointer parent,
+							size_type depth, size_type red_depth, size_type split_depth,
+							node_pointer* slot, ft::vector<_build_task>& tasks)
+		{
+			if (first == last)
+			{
+				*slot = _nil;
+				return ;
+			}
+			if (depth == split_depth)
+			{
+				_build_task t = { first, last, parent, depth, slot };
+				tasks.push_back(t);
+				return ;
+			}
+			size_type mid = first + (last - first) / 2;
+
+			node_pointer x = _create_node(get(mid), parent, depth == red_depth ? red : black);
+			*slot = x;
+			_build_top(get, first, mid, x, depth + 1, red_depth, split_depth, &x->_left, tasks);
+			_build_top(get, mid + 1, last, x, depth + 1, red_depth, split_depth, &x->_right, tasks);
+		}
+
 	private:
+		void _init_nil()
+		{
+			_nil->init(_nil, _nil, _nil, black);
+# ifdef FT_RBTREE_THREADED
+			_nil->_prev = _nil;
+			_nil->_next = _nil;
+# endif
+		}
+
+// in-order threads (FT_RBTREE_THREADED): circular list through _nil, rotations keep it intact
+		/* x is a fresh leaf: its neighbours are its parent and the parent's old neighbour */
+		void _thread_link(node_pointer x)
+		{
+# ifdef FT_RBTREE_THREADED
+			node_pointer parent = x->parent();
+			node_pointer pred, succ;
+			if (parent == _nil)
+			{
+				pred = _nil;
+				succ = _nil;
+			}
+			else if (parent->_left == x)
+			{
+				pred = parent->_prev;
+				succ = parent;
+			}
+			else
+			{
+				pred = parent;
+				succ = parent->_next;
+			}
+			x->_prev = pred;
+			x->_next = succ;
+			pred->_next = x;
+			succ->_prev = x;
+# else
+			(void)x;
+# endif
+		}
+
+		void _thread_unlink(node_pointer pos)
+		{
+# ifdef FT_RBTREE_THREADED
+			pos->_prev->_next = pos->_next;
+			pos->_next->_prev = pos->_prev;
+# else
+			(void)pos;
+# endif
+		}
+
+		/* rethread the whole tree after a copy or a bulk build */
+		void _thread_all()
+		{
+# ifdef FT_RBTREE_THREADED
+			node_pointer last = _nil;
+			_thread_subtree(_root, last);
+			last->_next = _nil;
+			_nil->_prev = last;
+# endif
+		}
+
+# ifdef FT_RBTREE_THREADED
+		void _thread_subtree(node_pointer node, node_pointer& last)
+		{
+			if (node == _nil)
+				return ;
+			_thread_subtree(node->_left, last);
+			node->_prev = last;
+			last->_next = node;
+			last = node;
+			_thread_subtree(node->_right, last);
+		}
+# endif
+
+		/* hang new red node x on the side of parent found by _descend */
+		void _link(node_pointer x, node_pointer parent, bool left)
+		{
+			if (parent == _nil)
+				_root = x;
+			else if (left)
+				parent->_left = x;
+			else
+				parent->_right = x;
+
+			_thread_link(x);
+			_augment_path(x);
+			_insertFixup(x);
+			_nil->set_parent(tree_max(_root));
+			++_size;
+		}
+
+//http://algolist.manual.ru/ds/rbtree.php
+		/* unlink pos from the tree without touching its value, other nodes stay put */
+		void _detach(node_pointer pos)
+		{
+			node_pointer x, y;
+
+			_thread_unlink(pos);
+
+			if (pos->_left == _nil || pos->_right == _nil) 
+			{		
+				/* y has a NIL node as a child */
+				y = pos;
+			}
+			else 
+			{
+				/* find tree successor with a NIL node as a child */
+				y = pos->_right;
+				while (y->_left != _nil) 
+					y = y->_left;
+			}
+
+			/* x is y's only child */
+			if (y->_left != _nil)
+				x = y->_left;
+			else
+				x = y->_right;
+
+			/* remove y from the parent chain */
+			x->set_parent(y->parent());
+			if (y->parent() != _nil)
+				if (y == y->parent()->_left)
+					y->parent()->_left = x;
+				else
+					y->parent()->_right = x;
+			else
+				_root = x;
+
+			NodeType y_type = y->type();
+			if (y != pos)
+			{
+				/* move y into the place of pos instead of copying its value */
+				y->set_parent(pos->parent());
+				y->_left = pos->_left;
+				y->_right = pos->_right;
+				_recolor(y, pos->type());
+				if (pos->parent() != _nil)
+					if (pos == pos->parent()->_left)
+						pos->parent()->_left = y;
+					else
+						pos->parent()->_right = y;
+				else
+					_root = y;
+				if (y->_left != _nil)
+					y->_left->set_parent(y);
+				if (y->_right != _nil)
+					y->_right->set_parent(y);
+				if (x->parent() == pos)
+					x->set_parent(y);
+			}
+
+			/* x's parent is the lowest node whose subtree changed, y is above it */
+			_augment_path(x->parent());
+			if (y_type == black)
+				_deleteFixup(x);
+			_nil->set_parent(tree_max(_root));
+			_size--;
+		}
+
+		/* links and color are set here, the value is constructed in place */
+		node_pointer _create_node(const value_type& value, node_pointer parent, NodeType type)
+		{
+			node_pointer x = _alloc_node.allocate(1);
+			try
+			{
+				_alloc_value.construct(&x->_value, value);
+			}
+			catch (...)
+			{
+				_alloc_node.deallocate(x, 1);
+				throw ;
+			}
+			x->init(parent, _nil, _nil, type);
+			return x;
+		}
+
+		void _destroy_node(node_pointer x)
+		{
+			_alloc_value.destroy(&x->_value);
+			_alloc_node.deallocate(x, 1);
+		}
+
 		node_pointer	tree_min(node_pointer node) const
 		{
 			while (node != _nil && node->_left != _nil) 
@@ -375,28 +903,197 @@ namespace ft
 			return node;
 		}
 
+		/* nothing to destroy nor free: the arena takes the nodes back at once */
 		void clear_node(node_pointer node)
 		{
+			if (ft::is_trivially_destructible<value_type>::value
+				&& ft::is_monotonic_allocator<allocator_type>::value)
+				return ;
 			if (node != _nil)
 			{
 				clear_node(node->_right);
 				clear_node(node->_left);
-				_alloc_value.destroy(node->_value);
-				_alloc_value.deallocate(node->_value, 1);
-				_alloc_node.deallocate(node, 1);
+				_destroy_node(node);
 			}
 		}
 
 //http://algolist.manual.ru/ds/rbtree.php		
+		/*
+		* One comparison per level: the descent remembers the last node it
+		* left to the right (the greatest node not greater than value) and
+		* checks that one for equality once at the bottom, depth + 1
+		* comparisons instead of up to 2 * depth. Both children are
+		* prefetched while the comparator runs on node.
+		*/
 		node_pointer _search(const value_type &value, node_pointer node) const
 		{
-			if(!node || node == _nil)
-				return node_pointer(_nil);
-			if (_comp(value, *node->_value))
-				return _search(value, node->_left);
-			if (_comp(*node->_value, value))
-				return _search(value, node->_right);
-			return node;
+			prefix_type word = prefix::get(value);
+			node_pointer candidate = _nil;
+			while (node != _nil)
+			{
+				FT_PREFETCH(node->_left);
+				FT_PREFETCH(node->_right);
+				if (_less(value, word, node))
+					node = node->_left;
+				else
+				{
+					candidate = node;
+					node = node->_right;
+				}
+			}
+			if (candidate != _nil && _less(candidate, value, word))
+				return _nil;
+			return candidate;
+		}
+
+		/*
+		* Same descent for insertion: returns the node equal to value, or
+		* _nil with the leaf slot for it in parent and left.
+		*/
+		node_pointer _descend(const value_type& value, node_pointer& parent, bool& left) const
+		{
+			prefix_type word = prefix::get(value);
+			node_pointer node = _root;
+			node_pointer candidate = _nil;
+			parent = _nil;
+			left = false;
+			while (node != _nil)
+			{
+				parent = node;
+				FT_PREFETCH(node->_left);
+				FT_PREFETCH(node->_right);
+				left = _less(value, word, node);
+				if (left)
+					node = node->_left;
+				else
+				{
+					candidate = node;
+					node = node->_right;
+				}
+			}
+			if (candidate != _nil && !_less(candidate, value, word))
+				return candidate;
+			return _nil;
+		}
+
+		/* adds the depth of every node below node to total, deepest to max */
+		void _depths(node_pointer node, std::size_t depth, std::size_t& total, std::size_t& max) const
+		{
+			for (; node != _nil; node = node->_right, ++depth)
+			{
+				total += depth;
+				if (depth > max)
+					max = depth;
+				_depths(node->_left, depth + 1, total, max);
+			}
+		}
+
+		bool _less(const value_type& x, const value_type& y) const
+		{
+			FT_RBTREE_COUNT(comparisons, 1);
+			return _comp(x, y);
+		}
+
+		/*
+		* value < node, decided on the prefix words when they differ. word
+		* is prefix::get(value), taken once per descent; the full
+		* comparison runs only on a tie.
+		*/
+		bool _less(const value_type& value, prefix_type word, node_pointer node) const
+		{
+			if (prefix::enabled)
+			{
+				prefix_type w = prefix::get(node->_value);
+				if (word != w)
+					return word < w;
+			}
+			return _less(value, node->_value);
+		}
+
+		/* node < value, same rule */
+		bool _less(node_pointer node, const value_type& value, prefix_type word) const
+		{
+			if (prefix::enabled)
+			{
+				prefix_type w = prefix::get(node->_value);
+				if (w != word)
+					return w < word;
+			}
+			return _less(node->_value, value);
+		}
+
+		void _augment(node_pointer x)
+		{
+			Augment::update(x, _nil, _comp);
+		}
+
+		/* x and every ancestor, after x's subtree changed */
+		void _augment_path(node_pointer x)
+		{
+			if (Augment::enabled)
+				for (; x != _nil; x = x->parent())
+					_augment(x);
+		}
+
+		/* children first, after a bulk build */
+		void _augment_all(node_pointer x)
+		{
+			if (!Augment::enabled || x == _nil)
+				return ;
+			_augment_all(x->_left);
+			_augment_all(x->_right);
+			_augment(x);
+		}
+
+		/* set_type that counts the calls that change the color */
+		void _recolor(node_pointer x, NodeType type)
+		{
+			FT_RBTREE_COUNT(recolors, x->type() != type);
+			x->set_type(type);
+		}
+
+		/* first node not less than value, _nil if none */
+		node_pointer _lower_bound(const value_type& value) const
+		{
+			FT_PERF_SCOPE("RBTree::lower_bound");
+			prefix_type word = prefix::get(value);
+			node_pointer node = _root;
+			node_pointer res = _nil;
+			while (node != _nil)
+			{
+				FT_PREFETCH(node->_left);
+				FT_PREFETCH(node->_right);
+				if (_less(node, value, word))
+					node = node->_right;
+				else
+				{
+					res = node;
+					node = node->_left;
+				}
+			}
+			return res;
+		}
+
+		/* first node greater than value, _nil if none */
+		node_pointer _upper_bound(const value_type& value) const
+		{
+			FT_PERF_SCOPE("RBTree::upper_bound");
+			prefix_type word = prefix::get(value);
+			node_pointer node = _root;
+			node_pointer res = _nil;
+			while (node != _nil)
+			{
+				FT_PREFETCH(node->_left);
+				FT_PREFETCH(node->_right);
+				if (_less(value, word, node))
+				{
+					res = node;
+					node = node->_left;
+				}
+				else
+					node = node->_right;
+			}
+			return res;
 		}
 
 //http://algolist.manual.ru/ds/rbtree.php
@@ -405,23 +1102,24 @@ namespace ft
 			/**************************
 			*  rotate node x to left *
 			**************************/
+			FT_RBTREE_COUNT(rotations, 1);
 
 			node_pointer y = x->_right;
 
 			/* establish x->right link */
 			x->_right = y->_left;
 			if (y->_left != _nil) 
-				y->_left->_parent = x;
+				y->_left->set_parent(x);
 
 			/* establish y->parent link */
 			if (y != _nil) 
-				y->_parent = x->_parent;
-			if (x->_parent != _nil) 
+				y->set_parent(x->parent());
+			if (x->parent() != _nil) 
 			{
-				if (x == x->_parent->_left)
-					x->_parent->_left = y;
+				if (x == x->parent()->_left)
+					x->parent()->_left = y;
 				else
-					x->_parent->_right = y;
+					x->parent()->_right = y;
 			} 
 			else 
 			{
@@ -431,7 +1129,9 @@ namespace ft
 			/* link x and y */
 			y->_left = x;
 			if (x != _nil) 
-				x->_parent = y;
+				x->set_parent(y);
+			_augment(x);
+			_augment(y);
 		}
 
 //http://algolist.manual.ru/ds/rbtree.php
@@ -440,23 +1140,24 @@ namespace ft
 			/****************************
 			*  rotate node x to right  *
 			****************************/
+			FT_RBTREE_COUNT(rotations, 1);
 
 			node_pointer y = x->_left;
 
 			/* establish x->left link */
 			x->_left = y->_right;
 			if (y->_right != _nil) 
-				y->_right->_parent = x;
+				y->_right->set_parent(x);
 
 			/* establish y->parent link */
 			if (y != _nil) 
-				y->_parent = x->_parent;
-			if (x->_parent != _nil)
+				y->set_parent(x->parent());
+			if (x->parent() != _nil)
 			{
-				if (x == x->_parent->_right)
-					x->_parent->_right = y;
+				if (x == x->parent()->_right)
+					x->parent()->_right = y;
 				else
-					x->_parent->_left = y;
+					x->parent()->_left = y;
 			} 
 			else 
 			{
@@ -466,7 +1167,9 @@ namespace ft
 			/* link x and y */
 			y->_right = x;
 			if (x != _nil) 
-				x->_parent = y;
+				x->set_parent(y);
+			_augment(x);
+			_augment(y);
 		}
 
 //http://algolist.manual.ru/ds/rbtree.php
@@ -478,62 +1181,62 @@ namespace ft
 			*************************************/
 
 			/* check Red-Black properties */
-			while (x != _root && x->_parent->_type == red) 
+			while (x != _root && x->parent()->type() == red) 
 			{
 				/* we have a violation */
-				if (x->_parent == x->_parent->_parent->_left) 
+				if (x->parent() == x->parent()->parent()->_left) 
 				{
-					node_pointer y = x->_parent->_parent->_right;
-					if (y->_type == red) 
+					node_pointer y = x->parent()->parent()->_right;
+					if (y->type() == red) 
 					{
 						/* uncle is RED */
-						x->_parent->_type = black;
-						y->_type = black;
-						x->_parent->_parent->_type = red;
-						x = x->_parent->_parent;
+						_recolor(x->parent(), black);
+						_recolor(y, black);
+						_recolor(x->parent()->parent(), red);
+						x = x->parent()->parent();
 					} 
 					else 
 					{
 						/* uncle is BLACK */
-						if (x == x->_parent->_right) 
+						if (x == x->parent()->_right) 
 						{
 							/* make x a left child */
-							x = x->_parent;
+							x = x->parent();
 							_rotateLeft(x);
 						}
 						/* recolor and rotate */
-						x->_parent->_type = black;
-						x->_parent->_parent->_type = red;
-						_rotateRight(x->_parent->_parent);
+						_recolor(x->parent(), black);
+						_recolor(x->parent()->parent(), red);
+						_rotateRight(x->parent()->parent());
 					}
 				} 
 				else 
 				{
 					/* mirror image of above code */
-					node_pointer y = x->_parent->_parent->_left;
-					if (y->_type == red) 
+					node_pointer y = x->parent()->parent()->_left;
+					if (y->type() == red) 
 					{
 						/* uncle is RED */
-						x->_parent->_type = black;
-						y->_type = black;
-						x->_parent->_parent->_type = red;
-						x = x->_parent->_parent;
+						_recolor(x->parent(), black);
+						_recolor(y, black);
+						_recolor(x->parent()->parent(), red);
+						x = x->parent()->parent();
 					} 
 					else 
 					{
 						/* uncle is BLACK */
-						if (x == x->_parent->_left) 
+						if (x == x->parent()->_left) 
 						{
-							x = x->_parent;
+							x = x->parent();
 							_rotateRight(x);
 						}
-						x->_parent->_type = black;
-						x->_parent->_parent->_type = red;
-						_rotateLeft(x->_parent->_parent);
+						_recolor(x->parent(), black);
+						_recolor(x->parent()->parent(), red);
+						_rotateLeft(x->parent()->parent());
 					}
 				}
 			}
-			_root->_type = black;
+			_recolor(_root, black);
 		}
 
 //http://algolist.manual.ru/ds/rbtree.php
@@ -544,91 +1247,90 @@ namespace ft
 			 *  after deleting node x            *
 			 *************************************/
 
-			while (x != _root && x->_type == black) 
+			while (x != _root && x->type() != red) 
 			{
-				if (x == x->_parent->_left)
+				if (x == x->parent()->_left)
 				{
-					node_pointer w = x->_parent->_right;
-					if (w->_type == red) 
+					node_pointer w = x->parent()->_right;
+					if (w->type() == red) 
 					{
-						w->_type = black;
-						x->_parent->_type = red;
-						_rotateLeft(x->_parent);
-						w = x->_parent->_right;
+						_recolor(w, black);
+						_recolor(x->parent(), red);
+						_rotateLeft(x->parent());
+						w = x->parent()->_right;
 					}
-					if (w->_left->_type==black && w->_right->_type==black)
+					if (w->_left->type() != red && w->_right->type() != red)
 					{
-						w->_type = red;
-						x = x->_parent;
+						_recolor(w, red);
+						x = x->parent();
 					}
 					else
 					{
-						if (w->_right->_type==black) 
+						if (w->_right->type() != red) 
 						{
-							w->_left->_type = black;
-							w->_type = red;
+							_recolor(w->_left, black);
+							_recolor(w, red);
 							_rotateRight(w);
-							w = x->_parent->_right;
+							w = x->parent()->_right;
 						}
-						w->_type = x->_parent->_type;
-						x->_parent->_type = black;
-						w->_right->_type = black;
-						_rotateLeft(x->_parent);
+						_recolor(w, x->parent()->type());
+						_recolor(x->parent(), black);
+						_recolor(w->_right, black);
+						_rotateLeft(x->parent());
 						x = _root;
 					}
 				}
 				else 
 				{
-					node_pointer w = x->_parent->_left;
-					if (w->_type==red)
+					node_pointer w = x->parent()->_left;
+					if (w->type()==red)
 					{
-						w->_type = black;
-						x->_parent->_type = red;
-						_rotateRight(x->_parent);
-						w = x->_parent->_left;
+						_recolor(w, black);
+						_recolor(x->parent(), red);
+						_rotateRight(x->parent());
+						w = x->parent()->_left;
 					}
-					if (w->_right->_type == black && w->_left->_type==black)
+					if (w->_right->type() != red && w->_left->type() != red)
 					{
-						w->_type = red;
-						x = x->_parent;
+						_recolor(w, red);
+						x = x->parent();
 					}
 					else
 					{
-						if (w->_left->_type==black)
+						if (w->_left->type() != red)
 						{
-							w->_right->_type = black;
-							w->_type = red;
+							_recolor(w->_right, black);
+							_recolor(w, red);
 							_rotateLeft(w);
-							w = x->_parent->_left;
+							w = x->parent()->_left;
 						}
-						w->_type = x->_parent->_type;
-						x->_parent->_type = black;
-						w->_left->_type = black;
-						_rotateRight(x->_parent);
+						_recolor(w, x->parent()->type());
+						_recolor(x->parent(), black);
+						_recolor(w->_left, black);
+						_rotateRight(x->parent());
 						x = _root;
 					}
 				}
 			}
-			if (x->_type != nil)
-				x->_type = black;
+			_recolor(x, black);
 		}
 
 	};
 
-	template<class Content, class Compare, class Alloc>
-	bool operator<(const RBTree<Content, Compare, Alloc>& lhs,  const RBTree<Content, Compare, Alloc>& rhs)
+	template<class Content, class Compare, class Alloc, class Augment>
+	bool operator<(const RBTree<Content, Compare, Alloc, Augment>& lhs,  const RBTree<Content, Compare, Alloc, Augment>& rhs)
 	{
 		return (ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()));
 	}
 
-	template<class Content, class Compare, class Alloc>
-	bool operator>(const RBTree<Content, Compare, Alloc>& lhs,  const RBTree<Content, Compare, Alloc>& rhs)
+	template<class Content, class Compare, class Alloc, class Augment>
+	bool operator>(const RBTree<Content, Compare, Alloc, Augment>& lhs,  const RBTree<Content, Compare, Alloc, Augment>& rhs)
 	{
 		return (lhs < rhs);
 	}
 
-	template<class Content, class Compare, class Alloc>
-	bool operator==(const RBTree<Content, Compare, Alloc>& lhs, const RBTree<Content, Compare, Alloc>& rhs)
+	template<class Content, class Compare, class Alloc, class Augment>
+	bool operator==(const RBTree<Content, Compare, Alloc, Augment>& lhs, const RBTree<Content, Compare, Alloc, Augment>& rhs)
 	{
 		return (lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin()));
 	}
@@ -1,58 +1,71 @@
 #ifndef RBTREE_NODE_HPP
 # define RBTREE_NODE_HPP
 
-namespace ft 
+# include <cstddef>
+
+namespace ft
 {
-	enum NodeType 
+	enum NodeType
 	{
 		black,
-		red,
-		nil
+		red
 	};
 
+	/*
+	* Compact node: the color lives in the low bit of the parent pointer
+	* (nodes are at least pointer aligned) and the value is stored inline.
+	* Nodes are never constructed as a whole: the tree allocates raw memory,
+	* constructs _value in place and sets the links with init().
+	* The sentinel has no value and is the only node linked to itself.
+	* With FT_RBTREE_THREADED every node also carries its in-order
+	* neighbours, so iterator steps are a single pointer load.
+	*/
 	template<class Value>
 	class RBTree_Node
 	{
 	public:
 		typedef	RBTree_Node*	node_pointer;
 
-		node_pointer	_parent;
+		std::size_t		_parent_type;
 		node_pointer	_left;
 		node_pointer	_right;
-		NodeType		_type;
-		Value*			_value;
-
-		 RBTree_Node(node_pointer parent,
-					node_pointer left,
-					node_pointer right,
-					NodeType type = black,
-					Value	*value = NULL):
-			_parent(parent),
-			_left(left),
-			_right(right),
-			_type(type),
-			_value(value)
-		{}
-
-		RBTree_Node(RBTree_Node const &copy)
+# ifdef FT_RBTREE_THREADED
+		node_pointer	_prev;
+		node_pointer	_next;
+# endif
+		Value			_value;
+
+		void init(node_pointer parent, node_pointer left, node_pointer right, NodeType type)
+		{
+			_parent_type = reinterpret_cast<std::size_t>(parent) | type;
+			_left = left;
+			_right = right;
+		}
+
+		node_pointer parent() const
+		{
+			return reinterpret_cast<node_pointer>(_parent_type & ~std::size_t(1));
+		}
+
+		NodeType type() const
 		{
-			*this = copy;
+			return static_cast<NodeType>(_parent_type & 1);
 		}
 
-		RBTree_Node& operator=(const RBTree_Node& copy)
+		void set_parent(node_pointer parent)
 		{
-			if (this == &copy)
-				return *this;		
-			_parent = copy._parent;
-			_left = copy._left;
-			_right = copy._right;
-			_value = copy._value;
-			_type = copy._type;
-			return *this;
-		}	
-
-		~RBTree_Node()
-		{}
+			_parent_type = reinterpret_cast<std::size_t>(parent) | (_parent_type & 1);
+		}
+
+		void set_type(NodeType type)
+		{
+			_parent_type = (_parent_type & ~std::size_t(1)) | type;
+		}
+
+		bool is_nil() const
+		{
+			return _right == this;
+		}
 	};
 
 }
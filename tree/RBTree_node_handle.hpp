@@ -0,0 +1,90 @@
+#ifndef RBTREE_NODE_HANDLE_HPP
+# define RBTREE_NODE_HANDLE_HPP
+
+# include <memory>
+# include "RBTree_Node.hpp"
+
+namespace ft
+{
+// C++17 node_type for map/set, ownership passes on copy (like std::auto_ptr)
+	template<class Value,
+				class Allocator = std::allocator<Value> >
+	class RBTree_node_handle
+	{
+	public:
+		typedef				Value											value_type;
+		typedef				Allocator										allocator_type;
+		typedef				RBTree_Node<Value>								Node;
+		typedef				Node*											node_pointer;
+		typedef typename	allocator_type::template rebind<Node>::other	allocator_node;
+
+	private:
+		mutable node_pointer	_node;
+		allocator_type			_alloc;
+
+	public:
+		RBTree_node_handle():
+			_node(NULL),
+			_alloc(allocator_type())
+		{}
+
+		RBTree_node_handle(node_pointer node, const allocator_type& alloc):
+			_node(node),
+			_alloc(alloc)
+		{}
+
+		RBTree_node_handle(const RBTree_node_handle& other):
+			_node(other.release()),
+			_alloc(other._alloc)
+		{}
+
+		RBTree_node_handle& operator=(const RBTree_node_handle& other)
+		{
+			if (this == &other)
+				return *this;
+			_destroy();
+			_alloc = other._alloc;
+			_node = other.release();
+			return *this;
+		}
+
+		~RBTree_node_handle()
+		{
+			_destroy();
+		}
+
+		bool empty() const { return _node == NULL; }
+		allocator_type get_allocator() const { return _alloc; }
+		value_type& value() const { return _node->_value; }
+
+		node_pointer release() const
+		{
+			node_pointer tmp = _node;
+			_node = NULL;
+			return tmp;
+		}
+
+		void swap(RBTree_node_handle& other)
+		{
+			node_pointer tmp_node = _node;
+			allocator_type tmp_alloc = _alloc;
+			_node = other._node;
+			_alloc = other._alloc;
+			other._node = tmp_node;
+			other._alloc = tmp_alloc;
+		}
+
+	private:
+		void _destroy()
+		{
+			if (_node == NULL)
+				return ;
+			allocator_node alloc_node(_alloc);
+			_alloc.destroy(&_node->_value);
+			alloc_node.deallocate(_node, 1);
+			_node = NULL;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,334 @@
+#ifndef RADIX_NODE_HPP
+# define RADIX_NODE_HPP
+
+# include <cstddef>
+# include <string>
+# include "../utils/utils.hpp"
+# ifdef __SSE2__
+#  include <emmintrin.h>
+# endif
+
+namespace ft
+{
+/*
+* A key as the byte string the radix_map branches on: size(k) bytes,
+* at(k, i) the i-th. Byte order must be the iteration order, so integers
+* are big-endian with the sign bit flipped and strings are their chars.
+*/
+	template<class Key, class Enable = void>
+	struct radix_key;
+
+	template<class Key>
+	struct radix_key<Key, typename ft::enable_if<ft::is_integral<Key>::value>::type>
+	{
+		static std::size_t size(const Key&) { return sizeof(Key); }
+
+		static unsigned char at(const Key& k, std::size_t i)
+		{
+			unsigned long long u = static_cast<unsigned long long>(k);
+			if (Key(-1) < Key(0))
+				u ^= 1ULL << (sizeof(Key) * 8 - 1);
+			return static_cast<unsigned char>(u >> ((sizeof(Key) - 1 - i) * 8));
+		}
+	};
+
+	template<>
+	struct radix_key<std::string>
+	{
+		static std::size_t size(const std::string& k) { return k.size(); }
+		static unsigned char at(const std::string& k, std::size_t i) { return static_cast<unsigned char>(k[i]); }
+	};
+
+	enum radix_node_type
+	{
+		radix_leaf,
+		radix_node4_type,
+		radix_node16_type,
+		radix_node48_type,
+		radix_node256_type
+	};
+
+	enum { radix_max_prefix = 8 };
+
+	struct radix_node
+	{
+		unsigned char	_type;
+	};
+
+	/* the in-order leaf list, circular through the map's head */
+	struct radix_link
+	{
+		radix_link*	_prev;
+		radix_link*	_next;
+	};
+
+	template<class Value>
+	struct radix_leaf_node: public radix_node, public radix_link
+	{
+		Value	_value;
+	};
+
+/*
+* Inner nodes keep the compressed path above their children: _prefix_len
+* bytes, of which the first radix_max_prefix are stored; a longer prefix
+* is read back from any leaf below. _leaf holds the key that ends right
+* after the prefix (a string that is a prefix of others), it sorts first.
+*/
+	struct radix_inner: public radix_node
+	{
+		unsigned short	_count;
+		unsigned		_prefix_len;
+		unsigned char	_prefix[radix_max_prefix];
+		radix_node*		_leaf;
+	};
+
+	/* keys sorted, scanned */
+	struct radix_node4: public radix_inner
+	{
+		enum { capacity = 4, type = radix_node4_type };
+		unsigned char	_keys[4];
+		radix_node*		_child[4];
+	};
+
+	/* keys sorted, compared all at once with SSE2 */
+	struct radix_node16: public radix_inner
+	{
+		enum { capacity = 16, type = radix_node16_type };
+		unsigned char	_keys[16];
+		radix_node*		_child[16];
+	};
+
+	/* byte -> slot + 1 in _child, 0 if absent */
+	struct radix_node48: public radix_inner
+	{
+		enum { capacity = 48, type = radix_node48_type };
+		unsigned char	_index[256];
+		radix_node*		_child[48];
+	};
+
+	struct radix_node256: public radix_inner
+	{
+		enum { capacity = 256, type = radix_node256_type };
+		radix_node*		_child[256];
+	};
+
+// child access by key byte, the same for every node size
+	inline radix_node** radix_find_child(radix_inner* n, unsigned char b)
+	{
+		switch (n->_type)
+		{
+		case radix_node4_type:
+		{
+			radix_node4* x = static_cast<radix_node4*>(n);
+			for (unsigned i = 0; i < x->_count; ++i)
+				if (x->_keys[i] == b)
+					return &x->_child[i];
+			return 0;
+		}
+		case radix_node16_type:
+		{
+			radix_node16* x = static_cast<radix_node16*>(n);
+# ifdef __SSE2__
+			__m128i eq = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(b)),
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(x->_keys)));
+			unsigned mask = _mm_movemask_epi8(eq) & ((1u << x->_count) - 1);
+			return mask ? &x->_child[__builtin_ctz(mask)] : 0;
+# else
+			for (unsigned i = 0; i < x->_count; ++i)
+				if (x->_keys[i] == b)
+					return &x->_child[i];
+			return 0;
+# endif
+		}
+		case radix_node48_type:
+		{
+			radix_node48* x = static_cast<radix_node48*>(n);
+			return x->_index[b] ? &x->_child[x->_index[b] - 1] : 0;
+		}
+		default:
+		{
+			radix_node256* x = static_cast<radix_node256*>(n);
+			return x->_child[b] ? &x->_child[b] : 0;
+		}
+		}
+	}
+
+	/* slot of the child with the smallest key byte > b, b set to that byte; 0 if none */
+	inline radix_node** radix_next_slot(radix_inner* n, int& b)
+	{
+		switch (n->_type)
+		{
+		case radix_node4_type:
+		case radix_node16_type:
+		{
+			unsigned char* keys = n->_type == radix_node4_type
+				? static_cast<radix_node4*>(n)->_keys : static_cast<radix_node16*>(n)->_keys;
+			radix_node** child = n->_type == radix_node4_type
+				? static_cast<radix_node4*>(n)->_child : static_cast<radix_node16*>(n)->_child;
+			for (unsigned i = 0; i < n->_count; ++i)
+				if (keys[i] > b)
+				{
+					b = keys[i];
+					return &child[i];
+				}
+			return 0;
+		}
+		case radix_node48_type:
+		{
+			radix_node48* x = static_cast<radix_node48*>(n);
+			for (++b; b < 256; ++b)
+				if (x->_index[b])
+					return &x->_child[x->_index[b] - 1];
+			return 0;
+		}
+		default:
+		{
+			radix_node256* x = static_cast<radix_node256*>(n);
+			for (++b; b < 256; ++b)
+				if (x->_child[b])
+					return &x->_child[b];
+			return 0;
+		}
+		}
+	}
+
+	/* child with the smallest key byte > b (b = -1: the first child), 0 if none */
+	inline radix_node* radix_next_child(radix_inner* n, int b)
+	{
+		radix_node** slot = radix_next_slot(n, b);
+		return slot ? *slot : 0;
+	}
+
+	/* child with the largest key byte < b (b = 256: the last child), 0 if none */
+	inline radix_node* radix_prev_child(radix_inner* n, int b)
+	{
+		switch (n->_type)
+		{
+		case radix_node4_type:
+		case radix_node16_type:
+		{
+			unsigned char* keys = n->_type == radix_node4_type
+				? static_cast<radix_node4*>(n)->_keys : static_cast<radix_node16*>(n)->_keys;
+			radix_node** child = n->_type == radix_node4_type
+				? static_cast<radix_node4*>(n)->_child : static_cast<radix_node16*>(n)->_child;
+			for (unsigned i = n->_count; i > 0; --i)
+				if (keys[i - 1] < b)
+					return child[i - 1];
+			return 0;
+		}
+		case radix_node48_type:
+		{
+			radix_node48* x = static_cast<radix_node48*>(n);
+			for (int i = b - 1; i >= 0; --i)
+				if (x->_index[i])
+					return x->_child[x->_index[i] - 1];
+			return 0;
+		}
+		default:
+		{
+			radix_node256* x = static_cast<radix_node256*>(n);
+			for (int i = b - 1; i >= 0; --i)
+				if (x->_child[i])
+					return x->_child[i];
+			return 0;
+		}
+		}
+	}
+
+	/* n must have room and no child at b */
+	inline void radix_add_child(radix_inner* n, unsigned char b, radix_node* c)
+	{
+		switch (n->_type)
+		{
+		case radix_node4_type:
+		case radix_node16_type:
+		{
+			unsigned char* keys = n->_type == radix_node4_type
+				? static_cast<radix_node4*>(n)->_keys : static_cast<radix_node16*>(n)->_keys;
+			radix_node** child = n->_type == radix_node4_type
+				? static_cast<radix_node4*>(n)->_child : static_cast<radix_node16*>(n)->_child;
+			unsigned i = n->_count;
+			for (; i > 0 && keys[i - 1] > b; --i)
+			{
+				keys[i] = keys[i - 1];
+				child[i] = child[i - 1];
+			}
+			keys[i] = b;
+			child[i] = c;
+			break ;
+		}
+		case radix_node48_type:
+		{
+			radix_node48* x = static_cast<radix_node48*>(n);
+			unsigned slot = 0;
+			while (x->_child[slot])
+				++slot;
+			x->_child[slot] = c;
+			x->_index[b] = static_cast<unsigned char>(slot + 1);
+			break ;
+		}
+		default:
+			static_cast<radix_node256*>(n)->_child[b] = c;
+		}
+		++n->_count;
+	}
+
+	inline void radix_remove_child(radix_inner* n, unsigned char b)
+	{
+		switch (n->_type)
+		{
+		case radix_node4_type:
+		case radix_node16_type:
+		{
+			unsigned char* keys = n->_type == radix_node4_type
+				? static_cast<radix_node4*>(n)->_keys : static_cast<radix_node16*>(n)->_keys;
+			radix_node** child = n->_type == radix_node4_type
+				? static_cast<radix_node4*>(n)->_child : static_cast<radix_node16*>(n)->_child;
+			unsigned i = 0;
+			while (keys[i] != b)
+				++i;
+			for (; i + 1 < n->_count; ++i)
+			{
+				keys[i] = keys[i + 1];
+				child[i] = child[i + 1];
+			}
+			break ;
+		}
+		case radix_node48_type:
+		{
+			radix_node48* x = static_cast<radix_node48*>(n);
+			x->_child[x->_index[b] - 1] = 0;
+			x->_index[b] = 0;
+			break ;
+		}
+		default:
+			static_cast<radix_node256*>(n)->_child[b] = 0;
+		}
+		--n->_count;
+	}
+
+	inline unsigned radix_capacity(const radix_inner* n)
+	{
+		switch (n->_type)
+		{
+		case radix_node4_type: return radix_node4::capacity;
+		case radix_node16_type: return radix_node16::capacity;
+		case radix_node48_type: return radix_node48::capacity;
+		default: return radix_node256::capacity;
+		}
+	}
+
+	/* header and every child of from into the empty node to, on grow and shrink */
+	inline void radix_move_node(radix_inner* from, radix_inner* to)
+	{
+		to->_prefix_len = from->_prefix_len;
+		for (unsigned i = 0; i < radix_max_prefix; ++i)
+			to->_prefix[i] = from->_prefix[i];
+		to->_leaf = from->_leaf;
+		int b = -1;
+		for (radix_node** c = radix_next_slot(from, b); c; c = radix_next_slot(from, b))
+			radix_add_child(to, static_cast<unsigned char>(b), *c);
+	}
+}
+
+#endif
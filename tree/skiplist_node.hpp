@@ -0,0 +1,44 @@
+#ifndef SKIPLIST_NODE_HPP
+# define SKIPLIST_NODE_HPP
+
+# include <cstddef>
+
+namespace ft
+{
+/*
+* A skiplist_map tower: _height forward links, allocated past the end of
+* the struct. A link is the next node's address with bit 0 set once this
+* node is deleted at that level; a marked link never changes again, so a
+* CAS expecting the unmarked address fails on a deleted predecessor.
+*/
+	template<class Value>
+	struct skiplist_node
+	{
+		typedef std::size_t	link_type;
+
+		Value			_value;
+		skiplist_node*	_retired;
+		unsigned long	_retire_epoch;
+		unsigned		_height;
+		/* set once every level is linked; erase waits for it */
+		unsigned		_linked;
+		link_type		_next[1];
+
+		static skiplist_node* ptr(link_type link) { return reinterpret_cast<skiplist_node*>(link & ~link_type(1)); }
+		static bool marked(link_type link) { return link & 1; }
+		static link_type make(skiplist_node* node) { return reinterpret_cast<link_type>(node); }
+
+		link_type load(unsigned level) const { return __atomic_load_n(&_next[level], __ATOMIC_ACQUIRE); }
+
+		/* the live node after this one on level 0, 0 at the end */
+		skiplist_node* next_live() const
+		{
+			skiplist_node* x = ptr(load(0));
+			while (x && marked(x->load(0)))
+				x = ptr(x->load(0));
+			return x;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef EPOCH_HPP
+# define EPOCH_HPP
+
+# include <cstddef>
+# include <sched.h>
+
+namespace ft
+{
+/*
+* Epoch-based reclamation for the lock-free containers. Every operation
+* runs inside an epoch_guard, which publishes the global epoch it started
+* in through one of the reader slots. Memory unlinked while the epoch was
+* e may be freed once the epoch reaches e + 2: try_advance() only moves
+* the epoch on when every active slot has seen the current one, so by
+* then no operation that could still hold a pointer to it is running.
+* Slots are claimed with a CAS, starting from a hash of the caller's
+* stack address; with more than `slots` operations in flight the extra
+* ones wait for a slot. Uses the GCC/clang __atomic builtins.
+*/
+	class epoch_domain
+	{
+	public:
+		typedef unsigned long	epoch_type;
+
+		enum { slots = 128 };
+
+	private:
+		/* (epoch << 1) | 1 while an operation is active, 0 when free */
+		struct slot
+		{
+			epoch_type	_word;
+			char		_pad[64 - sizeof(epoch_type)];
+		};
+
+		epoch_type	_epoch;
+		char		_pad[64 - sizeof(epoch_type)];
+		slot		_slots[slots];
+
+		epoch_domain(const epoch_domain&);
+		epoch_domain& operator=(const epoch_domain&);
+
+	public:
+		/* starts at 2 so that current() - 2 never wraps */
+		epoch_domain(): _epoch(2)
+		{
+			for (unsigned i = 0; i < slots; ++i)
+				_slots[i]._word = 0;
+		}
+
+		epoch_type current() const { return __atomic_load_n(&_epoch, __ATOMIC_SEQ_CST); }
+
+		/* claims a slot in the current epoch, returns it for leave() */
+		unsigned enter()
+		{
+			char here;
+			std::size_t h = reinterpret_cast<std::size_t>(&here) >> 12;
+			unsigned i = static_cast<unsigned>((h * 0x9e3779b97f4a7c15ULL) >> 32) % slots;
+			for (unsigned tries = 1; ; ++tries)
+			{
+				epoch_type free = 0;
+				epoch_type word = (current() << 1) | 1;
+				if (__atomic_compare_exchange_n(&_slots[i]._word, &free, word,
+							false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+					break ;
+				i = (i + 1) % slots;
+				if (tries % slots == 0)
+					::sched_yield();
+			}
+			__atomic_thread_fence(__ATOMIC_SEQ_CST);
+			return i;
+		}
+
+		void leave(unsigned i)
+		{
+			__atomic_store_n(&_slots[i]._word, 0, __ATOMIC_RELEASE);
+		}
+
+		/*
+		* Moves the epoch on if no active slot lags behind, and returns the
+		* newest retire epoch that is now safe to free.
+		*/
+		epoch_type try_advance()
+		{
+			__atomic_thread_fence(__ATOMIC_SEQ_CST);
+			epoch_type e = current();
+			for (unsigned i = 0; i < slots; ++i)
+			{
+				epoch_type word = __atomic_load_n(&_slots[i]._word, __ATOMIC_SEQ_CST);
+				if ((word & 1) && (word >> 1) != e)
+					return e - 2;
+			}
+			/* on failure the CAS overwrites its expected value: keep e */
+			epoch_type expected = e;
+			__atomic_compare_exchange_n(&_epoch, &expected, e + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+			return e - 1;
+		}
+	};
+
+	/* the calling thread is inside an operation while one is alive */
+	class epoch_guard
+	{
+	private:
+		epoch_domain&	_domain;
+		unsigned		_slot;
+
+		epoch_guard(const epoch_guard&);
+		epoch_guard& operator=(const epoch_guard&);
+
+	public:
+		explicit epoch_guard(epoch_domain& domain): _domain(domain), _slot(domain.enter()) {}
+		~epoch_guard() { _domain.leave(_slot); }
+	};
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef HASH_HPP
+# define HASH_HPP
+
+# include <cstddef>
+# include <string>
+# include "utils.hpp"
+
+namespace ft
+{
+	/* splitmix64 finalizer: every input bit reaches the low bits a power-of-two table masks */
+	inline std::size_t hash_mix(unsigned long long x)
+	{
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+		return static_cast<std::size_t>(x ^ (x >> 31));
+	}
+
+	/* std::hash for C++98: integral types, pointers and std::string */
+	template <class T, class Enable = void>
+	struct hash;
+
+	template <class T>
+	struct hash<T, typename ft::enable_if<ft::is_integral<T>::value>::type>
+	{
+		std::size_t operator()(T x) const { return hash_mix(static_cast<unsigned long long>(x)); }
+	};
+
+	template <class T>
+	struct hash<T*>
+	{
+		std::size_t operator()(T* p) const { return hash_mix(reinterpret_cast<std::size_t>(p)); }
+	};
+
+	/* FNV-1a */
+	template <>
+	struct hash<std::string>
+	{
+		std::size_t operator()(const std::string& s) const
+		{
+			unsigned long long h = 0xcbf29ce484222325ULL;
+			for (std::size_t i = 0; i < s.size(); ++i)
+				h = (h ^ static_cast<unsigned char>(s[i])) * 0x100000001b3ULL;
+			return hash_mix(h);
+		}
+	};
+}
+
+#endif
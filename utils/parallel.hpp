@@ -0,0 +1,250 @@
+#ifndef PARALLEL_HPP
+# define PARALLEL_HPP
+
+# include <cstddef>
+# include <cstring>
+# include <new>
+# include <stdexcept>
+# include <string>
+# include <pthread.h>
+# include <unistd.h>
+
+namespace ft
+{
+	/* online cores, at least 1 */
+	inline unsigned hardware_threads()
+	{
+		long n = ::sysconf(_SC_NPROCESSORS_ONLN);
+		return n > 0 ? static_cast<unsigned>(n) : 1;
+	}
+
+/*
+* Thrown by parallel_for in place of a task's exception: C++98 cannot carry
+* an exception from one thread to another, so only its what() is kept.
+* std::bad_alloc is rethrown as itself.
+*/
+	class parallel_error : public std::runtime_error
+	{
+	public:
+		explicit parallel_error(const std::string& what): std::runtime_error(what) {}
+	};
+
+	enum parallel_failure
+	{
+		parallel_ok,
+		parallel_bad_alloc,
+		parallel_exception,
+		parallel_unknown
+	};
+
+	template <class Fn>
+	struct parallel_job
+	{
+		Fn*			_fn;
+		std::size_t	_n;
+		std::size_t	_next;
+		int			_failed;	/* parallel_failure of the first task that threw */
+		char		_what[128];
+	};
+
+	/* records the first failure and hands out no more indices */
+	template <class Fn>
+	void parallel_fail(parallel_job<Fn>* job, int kind, const char* what)
+	{
+		int expected = parallel_ok;
+		if (__atomic_compare_exchange_n(&job->_failed, &expected, kind,
+					false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+		{
+			std::strncpy(job->_what, what, sizeof(job->_what) - 1);
+			job->_what[sizeof(job->_what) - 1] = '\0';
+		}
+		__atomic_store_n(&job->_next, job->_n, __ATOMIC_RELAXED);
+	}
+
+	template <class Fn>
+	void* parallel_worker(void* arg)
+	{
+		parallel_job<Fn>* job = static_cast<parallel_job<Fn>*>(arg);
+		for (;;)
+		{
+			std::size_t i = __atomic_fetch_add(&job->_next, 1, __ATOMIC_RELAXED);
+			if (i >= job->_n)
+				break ;
+			try
+			{
+				(*job->_fn)(i);
+			}
+			catch (const std::bad_alloc&)
+			{
+				parallel_fail(job, parallel_bad_alloc, "std::bad_alloc");
+			}
+			catch (const std::exception& e)
+			{
+				parallel_fail(job, parallel_exception, e.what());
+			}
+			catch (...)
+			{
+				parallel_fail(job, parallel_unknown, "unknown exception");
+			}
+		}
+		return 0;
+	}
+
+/*
+* Worker threads kept between parallel_for calls: a call wakes the helpers
+* it needs instead of creating and joining threads, so a sort that runs
+* one parallel_for per merge round or radix pass starts its threads once.
+* Helpers are created on first need, at most 63, and joined at exit. One
+* fork-join runs at a time: run() returns false while the pool is busy.
+*/
+	class parallel_pool
+	{
+	public:
+		enum { max_helpers = 63 };
+
+		static parallel_pool& instance()
+		{
+			static parallel_pool pool;
+			return pool;
+		}
+
+		/* work(arg) on the caller and on up to `helpers` pool threads, returns once all are done */
+		bool run(void* (*work)(void*), void* arg, unsigned helpers)
+		{
+			if (::pthread_mutex_trylock(&_busy) != 0)
+				return false;
+			::pthread_mutex_lock(&_lock);
+			while (_nthreads < helpers && _nthreads < unsigned(max_helpers))
+			{
+				_workers[_nthreads]._pool = this;
+				_workers[_nthreads]._index = _nthreads;
+				_workers[_nthreads]._seen = _generation;
+				if (::pthread_create(&_ids[_nthreads], 0, &parallel_pool::_loop, &_workers[_nthreads]) != 0)
+					break ;
+				++_nthreads;
+			}
+			if (helpers > _nthreads)
+				helpers = _nthreads;
+			_work = work;
+			_arg = arg;
+			_helpers = helpers;
+			_running = helpers;
+			++_generation;
+			::pthread_cond_broadcast(&_wake);
+			::pthread_mutex_unlock(&_lock);
+			work(arg);
+			::pthread_mutex_lock(&_lock);
+			while (_running)
+				::pthread_cond_wait(&_done, &_lock);
+			::pthread_mutex_unlock(&_lock);
+			::pthread_mutex_unlock(&_busy);
+			return true;
+		}
+
+	private:
+		struct Worker
+		{
+			parallel_pool*	_pool;
+			unsigned		_index;
+			unsigned long	_seen;	/* last generation this worker woke for */
+		};
+
+		pthread_mutex_t	_busy;	/* held for a whole run() */
+		pthread_mutex_t	_lock;	/* guards the fields below */
+		pthread_cond_t	_wake;
+		pthread_cond_t	_done;
+		pthread_t		_ids[max_helpers];
+		Worker			_workers[max_helpers];
+		unsigned		_nthreads;
+		unsigned long	_generation;
+		unsigned		_helpers;	/* workers 0 .. _helpers - 1 take part in this generation */
+		unsigned		_running;
+		void*			(*_work)(void*);
+		void*			_arg;
+		bool			_stop;
+
+		parallel_pool(): _nthreads(0), _generation(0), _helpers(0), _running(0), _work(0), _arg(0), _stop(false)
+		{
+			::pthread_mutex_init(&_busy, 0);
+			::pthread_mutex_init(&_lock, 0);
+			::pthread_cond_init(&_wake, 0);
+			::pthread_cond_init(&_done, 0);
+		}
+
+		~parallel_pool()
+		{
+			::pthread_mutex_lock(&_lock);
+			_stop = true;
+			::pthread_cond_broadcast(&_wake);
+			::pthread_mutex_unlock(&_lock);
+			for (unsigned i = 0; i < _nthreads; ++i)
+				::pthread_join(_ids[i], 0);
+			::pthread_cond_destroy(&_done);
+			::pthread_cond_destroy(&_wake);
+			::pthread_mutex_destroy(&_lock);
+			::pthread_mutex_destroy(&_busy);
+		}
+
+		parallel_pool(const parallel_pool&);
+		parallel_pool& operator=(const parallel_pool&);
+
+		static void* _loop(void* arg)
+		{
+			Worker* self = static_cast<Worker*>(arg);
+			parallel_pool& pool = *self->_pool;
+			::pthread_mutex_lock(&pool._lock);
+			for (;;)
+			{
+				while (!pool._stop && self->_seen == pool._generation)
+					::pthread_cond_wait(&pool._wake, &pool._lock);
+				if (pool._stop)
+					break ;
+				self->_seen = pool._generation;
+				if (self->_index >= pool._helpers)
+					continue ;
+				void* (*work)(void*) = pool._work;
+				void* work_arg = pool._arg;
+				::pthread_mutex_unlock(&pool._lock);
+				work(work_arg);
+				::pthread_mutex_lock(&pool._lock);
+				if (--pool._running == 0)
+					::pthread_cond_signal(&pool._done);
+			}
+			::pthread_mutex_unlock(&pool._lock);
+			return 0;
+		}
+	};
+
+/*
+* Fork-join: runs fn(0) ... fn(n - 1) on up to `threads` threads, the
+* caller and parallel_pool helpers; threads pull the next index from a
+* shared counter so uneven tasks balance out. Returns when every call has
+* returned. At most 64 threads. If a helper cannot be started, or the
+* pool is busy (a parallel_for from a task, or from another thread), the
+* threads that did start take its share. Once a call throws no new index is
+* started; after the join the first failure is rethrown as std::bad_alloc
+* or parallel_error. Calls that did not run have had no effect.
+*/
+	template <class Fn>
+	void parallel_for(std::size_t n, Fn& fn, unsigned threads)
+	{
+		parallel_job<Fn> job;
+		job._fn = &fn;
+		job._n = n;
+		job._next = 0;
+		job._failed = parallel_ok;
+		job._what[0] = '\0';
+		if (threads > n)
+			threads = static_cast<unsigned>(n);
+		if (threads > 64)
+			threads = 64;
+		if (threads < 2 || !parallel_pool::instance().run(&parallel_worker<Fn>, &job, threads - 1))
+			parallel_worker<Fn>(&job);
+		if (job._failed == parallel_bad_alloc)
+			throw (std::bad_alloc());
+		if (job._failed != parallel_ok)
+			throw (parallel_error(job._what));
+	}
+}
+
+#endif
@@ -0,0 +1,268 @@
+#ifndef PERF_COUNTERS_HPP
+# define PERF_COUNTERS_HPP
+
+/*
+* Optional hardware counter instrumentation (-DFT_PERF_COUNTERS, Linux).
+* FT_PERF_SCOPE("name") at the top of a function adds the cycles,
+* instructions, L1D read misses, LLC misses and branch misses spent until
+* it returns to the totals of "name" (inclusive of nested scopes, user
+* space only). Counters are opened per thread with perf_event_open on
+* first use; each scope costs two read() syscalls, so time a build with
+* the macro off. Without FT_PERF_COUNTERS the macro expands to nothing.
+*/
+# ifndef FT_PERF_COUNTERS
+#  define FT_PERF_SCOPE(name)
+# else
+#  define FT_PERF_SCOPE(name) \
+	static ft::perf_site ft_perf_site_(name); \
+	ft::perf_scope ft_perf_scope_(ft_perf_site_)
+
+#  include <cstring>
+#  include <cstdio>
+#  include <ostream>
+#  ifdef __linux__
+#   include <linux/perf_event.h>
+#   include <sys/ioctl.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#  endif
+
+namespace ft
+{
+	enum perf_event_index
+	{
+		perf_cycles,
+		perf_instructions,
+		perf_l1d_misses,
+		perf_llc_misses,
+		perf_branch_misses,
+		perf_event_count
+	};
+
+	/* one counter snapshot; an event the CPU or kernel refuses stays 0 */
+	struct perf_sample
+	{
+		unsigned long long	value[perf_event_count];
+	};
+
+/*
+* The calling thread's counter group: the cycles counter leads, the
+* others are opened into its group so one read() returns all of them.
+* If perf_event_open is not permitted (perf_event_paranoid, containers)
+* available() is false and every sample is zero.
+*/
+	class perf_counters
+	{
+	private:
+		int		_leader;
+		int		_slot[perf_event_count];	/* position in the group read, -1 if not opened */
+		int		_opened;
+
+		perf_counters(const perf_counters&);
+		perf_counters& operator=(const perf_counters&);
+
+# ifdef __linux__
+		static int _open(unsigned type, unsigned long long config, int group)
+		{
+			struct perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = type;
+			attr.config = config;
+			attr.disabled = group == -1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_GROUP;
+			return ::syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+		}
+
+		void _add(perf_event_index i, unsigned type, unsigned long long config)
+		{
+			int fd = _open(type, config, _leader);
+			if (fd < 0)
+				return ;
+			_slot[i] = _opened++;
+		}
+# endif
+
+	public:
+		perf_counters(): _leader(-1), _opened(0)
+		{
+			for (int i = 0; i < perf_event_count; i++)
+				_slot[i] = -1;
+# ifdef __linux__
+			_leader = _open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+			if (_leader < 0)
+				return ;
+			_slot[perf_cycles] = _opened++;
+			_add(perf_instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+			_add(perf_l1d_misses, PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+					| (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+			_add(perf_llc_misses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+			_add(perf_branch_misses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+			::ioctl(_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+# endif
+		}
+
+		/* one per thread, never closed: the fds go away with the process */
+		static perf_counters& local()
+		{
+			static __thread perf_counters* counters = 0;
+			if (!counters)
+				counters = new perf_counters();
+			return *counters;
+		}
+
+		bool available() const { return _leader >= 0; }
+
+		void read(perf_sample& s) const
+		{
+			std::memset(&s, 0, sizeof(s));
+# ifdef __linux__
+			unsigned long long buf[1 + perf_event_count];
+			if (_leader < 0 || ::read(_leader, buf, sizeof(buf)) < ssize_t(sizeof(buf[0])))
+				return ;
+			for (int i = 0; i < perf_event_count; i++)
+				if (_slot[i] >= 0 && (unsigned long long)_slot[i] < buf[0])
+					s.value[i] = buf[1 + _slot[i]];
+# endif
+		}
+	};
+
+/*
+* Totals per operation name, in a fixed table shared by all threads
+* (relaxed atomic adds). Names longer than 47 characters are cut; once
+* the table is full, new names share the last entry, "(other)".
+* A template only so its statics can be defined in this header.
+*/
+	template <class Dummy = void>
+	class basic_perf_registry
+	{
+	public:
+		enum { max_sites = 128, name_size = 48 };
+
+		struct entry
+		{
+			char				name[name_size];
+			unsigned long long	calls;
+			unsigned long long	total[perf_event_count];
+		};
+
+	private:
+		static entry		_entries[max_sites];
+		static unsigned		_used;
+		static int			_lock;
+
+	public:
+		/* entry for name, created on first call */
+		static entry* get(const char* name)
+		{
+			while (__atomic_exchange_n(&_lock, 1, __ATOMIC_ACQUIRE))
+				;
+			entry* e = 0;
+			for (unsigned i = 0; i < _used && !e; i++)
+				if (!std::strncmp(_entries[i].name, name, name_size - 1))
+					e = &_entries[i];
+			if (!e && _used < max_sites - 1)
+			{
+				e = &_entries[_used++];
+				std::strncpy(e->name, name, name_size - 1);
+			}
+			else if (!e)
+			{
+				e = &_entries[max_sites - 1];
+				std::strncpy(e->name, "(other)", name_size - 1);
+				_used = max_sites;
+			}
+			__atomic_store_n(&_lock, 0, __ATOMIC_RELEASE);
+			return e;
+		}
+
+		static void add(entry* e, const perf_sample& from, const perf_sample& to)
+		{
+			__atomic_fetch_add(&e->calls, 1, __ATOMIC_RELAXED);
+			for (int i = 0; i < perf_event_count; i++)
+				__atomic_fetch_add(&e->total[i], to.value[i] - from.value[i], __ATOMIC_RELAXED);
+		}
+
+		/* zero the totals, names stay registered */
+		static void reset()
+		{
+			for (unsigned i = 0; i < max_sites; i++)
+			{
+				__atomic_store_n(&_entries[i].calls, 0, __ATOMIC_RELAXED);
+				for (int j = 0; j < perf_event_count; j++)
+					__atomic_store_n(&_entries[i].total[j], 0, __ATOMIC_RELAXED);
+			}
+		}
+
+		/* per call averages for every name called since the last reset */
+		static void report(std::ostream& os)
+		{
+			char line[256];
+			if (!perf_counters::local().available())
+				os << "perf counters unavailable (no PMU, or perf_event_open not permitted by /proc/sys/kernel/perf_event_paranoid)\n";
+			snprintf(line, sizeof(line), "%-40s %12s %10s %10s %6s %9s %9s %9s\n",
+					"op", "calls", "cycles", "instr", "ipc", "l1d_miss", "llc_miss", "br_miss");
+			os << line;
+			unsigned used = __atomic_load_n(&_used, __ATOMIC_ACQUIRE);
+			for (unsigned i = 0; i < used; i++)
+			{
+				const entry& e = _entries[i];
+				if (!e.calls)
+					continue ;
+				double n = double(e.calls);
+				snprintf(line, sizeof(line), "%-40s %12llu %10.1f %10.1f %6.2f %9.3f %9.3f %9.3f\n",
+						e.name, e.calls, e.total[perf_cycles] / n, e.total[perf_instructions] / n,
+						e.total[perf_cycles] ? double(e.total[perf_instructions]) / e.total[perf_cycles] : 0.0,
+						e.total[perf_l1d_misses] / n, e.total[perf_llc_misses] / n, e.total[perf_branch_misses] / n);
+				os << line;
+			}
+		}
+	};
+
+	template <class Dummy>
+	typename basic_perf_registry<Dummy>::entry basic_perf_registry<Dummy>::_entries[max_sites];
+
+	template <class Dummy>
+	unsigned basic_perf_registry<Dummy>::_used = 0;
+
+	template <class Dummy>
+	int basic_perf_registry<Dummy>::_lock = 0;
+
+	typedef basic_perf_registry<>	perf_registry;
+
+	/* a FT_PERF_SCOPE call site: resolves its registry entry once */
+	struct perf_site
+	{
+		perf_registry::entry*	_entry;
+
+		explicit perf_site(const char* name): _entry(perf_registry::get(name)) {}
+	};
+
+	class perf_scope
+	{
+	private:
+		perf_registry::entry*	_entry;
+		perf_sample				_start;
+
+		perf_scope(const perf_scope&);
+		perf_scope& operator=(const perf_scope&);
+
+	public:
+		explicit perf_scope(const perf_site& site): _entry(site._entry)
+		{
+			perf_counters::local().read(_start);
+		}
+
+		~perf_scope()
+		{
+			perf_sample end;
+			perf_counters::local().read(end);
+			perf_registry::add(_entry, _start, end);
+		}
+	};
+}
+# endif
+
+#endif
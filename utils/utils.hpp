@@ -1,7 +1,16 @@
 #ifndef UTILS_HPP
 # define UTILS_HPP
 
+# include <functional>
 # include "../iter/iterator.hpp"
+# include "perf_counters.hpp"
+
+// prefetch hint for pointer chasing, no-op without the GCC/clang builtin
+# if defined(__GNUC__) || defined(__clang__)
+#  define FT_PREFETCH(addr) __builtin_prefetch(addr)
+# else
+#  define FT_PREFETCH(addr) ((void)(addr))
+# endif
 
 namespace ft
 {
@@ -62,6 +71,98 @@ namespace ft
 	template< >	struct is_integral<long long> : public true_type {};
 	template< >	struct is_integral<unsigned long long> : public true_type {};
 
+//remove_const (reimplemented)
+	template<class T> struct remove_const { typedef T type; };
+	template<class T> struct remove_const <const T> { typedef T type; };
+
+//is_trivially_destructible / is_trivially_copyable / is_trivially_default_constructible: compiler builtins under GCC/clang, integral types only otherwise
+# if defined(__clang__)
+	template<class T> struct is_trivially_destructible : public integral_constant<bool, __is_trivially_destructible(T)> {};
+	template<class T> struct is_trivially_copyable : public integral_constant<bool, __is_trivially_copyable(T)> {};
+	template<class T> struct is_trivially_default_constructible : public integral_constant<bool, __is_trivially_constructible(T)> {};
+# elif defined(__GNUC__)
+	template<class T> struct is_trivially_destructible : public integral_constant<bool, __has_trivial_destructor(T)> {};
+	template<class T> struct is_trivially_copyable : public integral_constant<bool, __is_trivially_copyable(T)> {};
+	template<class T> struct is_trivially_default_constructible : public integral_constant<bool, __has_trivial_constructor(T)> {};
+# else
+	template<class T> struct is_trivially_destructible : public is_integral<T> {};
+	template<class T> struct is_trivially_copyable : public is_integral<T> {};
+	template<class T> struct is_trivially_default_constructible : public is_integral<T> {};
+# endif
+
+//is_monotonic_allocator: deallocate() is a no-op, memory goes back all at once (see arena_allocator)
+	template<class Allocator> struct is_monotonic_allocator : public false_type {};
+
+/*
+* key_prefix: ordering hook for key types whose comparison can start with
+* one word. get(x) returns a word whose unsigned order agrees with x's
+* order wherever two words differ; equal words leave the full comparison
+* to decide. Specialized by ft::basic_string.
+*/
+	template<class Key> struct key_prefix
+	{
+		enum { enabled = 0 };
+
+		typedef unsigned long long	type;
+
+		static type get(const Key&) { return 0; }
+	};
+
+/*
+* compare_prefix: the key_prefix a comparator orders by. Only std::less
+* agrees with it (map's value_compare forwards its key_compare's); for
+* any other comparator enabled is 0 and the RBTree descents ignore get().
+*/
+	template<class Compare> struct compare_prefix
+	{
+		enum { enabled = 0 };
+
+		typedef unsigned long long	type;
+
+		template<class Value>
+		static type get(const Value&) { return 0; }
+	};
+
+	template<class Key> struct compare_prefix<std::less<Key> > : public key_prefix<Key> {};
+
+//popcount / count trailing zeros / highest set bit (x != 0) of a word, POPCNT/TZCNT with the GCC/clang builtins
+	inline int popcount(unsigned long x)
+	{
+# if defined(__GNUC__) || defined(__clang__)
+		return __builtin_popcountl(x);
+# else
+		int n = 0;
+		for (; x; x &= x - 1)
+			++n;
+		return n;
+# endif
+	}
+
+	inline int count_trailing_zeros(unsigned long x)
+	{
+# if defined(__GNUC__) || defined(__clang__)
+		return __builtin_ctzl(x);
+# else
+		int n = 0;
+		for (; !(x & 1); x >>= 1)
+			++n;
+		return n;
+# endif
+	}
+
+	/* index of the highest set bit (x != 0), BSR/LZCNT with the GCC/clang builtins */
+	inline int floor_log2(unsigned long x)
+	{
+# if defined(__GNUC__) || defined(__clang__)
+		return int(sizeof(unsigned long) * 8 - 1) - __builtin_clzl(x);
+# else
+		int n = 0;
+		while (x >>= 1)
+			++n;
+		return n;
+# endif
+	}
+
 //lexicographical compare (reimplemented)
 	template<class InputIt1, class InputIt2>
 	bool lexicographical_compare(InputIt1 first1, InputIt1 last1,
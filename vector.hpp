@@ -2,6 +2,9 @@
 # define VECTOR_HPP
 
 # include <memory>
+# include <new>
+# include <cstring>
+# include <stdexcept>
 # include "./utils/utils.hpp"
 # include "./iter/iterator_random_access.hpp"
 # include "./iter/iterator_reverse.hpp"
@@ -156,6 +159,8 @@ namespace ft
 		size_type size() const { return _finish - _start; }
 		size_type capacity() const { return _end_of_storage - _start; }
 		size_type max_size() const { return allocator_type().max_size(); }
+		/* heap bytes held, unused capacity included */
+		size_type memory_usage() const { return capacity() * sizeof(value_type); }
 
 		bool empty() const
 		{
@@ -175,19 +180,43 @@ namespace ft
 			}
 			else
 			{
-				if (capacity() > sz)
-					;
-				else if (capacity() * 2 < sz)
-					reserve(sz);
-				else
-					reserve(capacity() * 2);
+				_grow_to(sz);
 				while (size() < sz)
 					_alloc.construct(_finish++, c);
 			}
 		}
 
+		/*
+		* resize() without a value: new elements are default-initialized, so
+		* for a trivially default constructible T (char, int, PODs) nothing is
+		* written, e.g. before read() fills the buffer.
+		*/
+		void resize_default_init(size_type sz)
+		{
+			if (sz > max_size())
+				throw (std::length_error("vector"));
+			while (size() > sz)
+				_alloc.destroy(--_finish);
+			_grow_to(sz);
+			if (ft::is_trivially_default_constructible<value_type>::value)
+				_finish = _start + sz;
+			else
+				while (size() < sz)
+				{
+					::new (static_cast<void*>(_finish)) value_type;
+					++_finish;
+				}
+		}
+
+		/* resize_default_init(): the new elements of a trivial T hold whatever the memory held */
+		void resize_uninitialized(size_type sz)
+		{
+			resize_default_init(sz);
+		}
+
 		void reserve(size_type n)
 		{
+			FT_PERF_SCOPE("vector::reserve");
 			if (n > max_size())
 				throw(std::length_error("vector"));
 			else if (n > capacity())
@@ -199,11 +228,18 @@ namespace ft
 				_start = _alloc.allocate(n);
 				_end_of_storage = _start + n;
 				_finish = _start;
-				while (prev_start != prev_end)
+				if (ft::is_trivially_copyable<value_type>::value)
 				{
-					_alloc.construct(_finish++, *prev_start);
-					_alloc.destroy(prev_start++);
+					if (prev_end != prev_start)
+						std::memcpy(static_cast<void*>(_start), prev_start, (prev_end - prev_start) * sizeof(value_type));
+					_finish = _start + (prev_end - prev_start);
 				}
+				else
+					while (prev_start != prev_end)
+					{
+						_alloc.construct(_finish++, *prev_start);
+						_alloc.destroy(prev_start++);
+					}
 				_alloc.deallocate(prev_start_save, prev_capacity);
 			}
 		}
@@ -233,6 +269,7 @@ namespace ft
 //Modifiers:	
 		void push_back(const value_type &value)
 		{
+			FT_PERF_SCOPE("vector::push_back");
 			if (_finish == _end_of_storage)
 			{
 				if (size() == 0)
@@ -253,8 +290,33 @@ namespace ft
 			_alloc.destroy(--_finish);
 		}
 
+		/* n elements from p, one memcpy for a trivially copyable T; p may point into the vector */
+		void append(const value_type* p, size_type n)
+		{
+			if (n > max_size() - size())
+				throw (std::length_error("vector"));
+			if (size() + n > capacity())
+			{
+				bool inside = p >= _start && p < _finish;
+				size_type offset = inside ? p - _start : 0;
+				_grow_to(size() + n);
+				if (inside)
+					p = _start + offset;
+			}
+			if (ft::is_trivially_copyable<value_type>::value)
+			{
+				if (n)
+					std::memcpy(static_cast<void*>(_finish), p, n * sizeof(value_type));
+				_finish += n;
+			}
+			else
+				for (size_type i = 0; i < n; ++i)
+					_alloc.construct(_finish++, p[i]);
+		}
+
 		iterator insert(iterator position, const T& x)
 		{
+			FT_PERF_SCOPE("vector::insert");
 			pointer pos = &(*position);
 			if (capacity() == 0)
 			{
@@ -264,12 +326,16 @@ namespace ft
 				_alloc.construct(_finish++, x);
 				return (iterator(_start));
 			}
-			else if (capacity() >= size() + 1)
+			/* x may be an element: read it before anything moves */
+			value_type copy(x);
+			if (capacity() >= size() + 1)
 			{
-				pointer tmp = _finish;
-				while (pos != tmp--)
-					_alloc.construct(tmp + 1, *tmp);
-				_alloc.construct(tmp, x);
+				for (pointer tmp = _finish; tmp != pos; --tmp)
+				{
+					_alloc.construct(tmp, *(tmp - 1));
+					_alloc.destroy(tmp - 1);
+				}
+				_alloc.construct(pos, copy);
 				_finish++;
 				return (position);
 			}
@@ -288,7 +354,7 @@ namespace ft
 					_alloc.construct(_finish++, *prev_start);
 					_alloc.destroy(prev_start++);
 				}
-				_alloc.construct(_finish++, x);
+				_alloc.construct(_finish++, copy);
 				while (prev_start != prev_end)
 				{
 					_alloc.construct(_finish++, *prev_start);
@@ -306,13 +372,17 @@ namespace ft
 				return ;
 			if (size() + n > max_size())
 				throw (std::length_error("vector"));	
+			/* x may be an element: read it before anything moves */
+			value_type copy(x);
 			if (capacity() >= size() + n)
 			{
-				pointer tmp = _finish;
-				while (pos != tmp--)
-					_alloc.construct(tmp + n, *tmp);
+				for (pointer tmp = _finish; tmp != pos; --tmp)
+				{
+					_alloc.construct(tmp - 1 + n, *(tmp - 1));
+					_alloc.destroy(tmp - 1);
+				}
 				for (size_type i = 0; i < n; i++)
-					_alloc.construct(tmp + i, x);
+					_alloc.construct(pos + i, copy);
 				_finish += n;
 			}
 			else
@@ -339,7 +409,7 @@ namespace ft
 					_alloc.destroy(prev_start++);
 				}
 				for (size_type i = 0; i < n; i++)
-					_alloc.construct(_finish++, x);
+					_alloc.construct(_finish++, copy);
 				while (prev_start != prev_end)
 				{
 					_alloc.construct(_finish++, *prev_start);
@@ -350,6 +420,14 @@ namespace ft
 		}
 
 	private:
+		/* resize()'s growth: sz, or twice the capacity when that is more */
+		void _grow_to(size_type sz)
+		{
+			if (sz <= capacity())
+				return ;
+			reserve(capacity() * 2 < sz ? sz : capacity() * 2);
+		}
+
 		template<class InputIt>
 		bool check_insert(InputIt first, InputIt last, difference_type n)
 		{
@@ -390,11 +468,13 @@ namespace ft
 				throw (std::length_error("vector"));
 			if (capacity() >= size() + n)
 			{				
-				pointer tmp = _finish;
-				while (pos != tmp--)
-					_alloc.construct(tmp + n, *tmp);
+				for (pointer tmp = _finish; tmp != pos; --tmp)
+				{
+					_alloc.construct(tmp - 1 + n, *(tmp - 1));
+					_alloc.destroy(tmp - 1);
+				}
 				for (size_type i = 0; i < (size_type)n; i++)
-					_alloc.construct(tmp + i, *first++);
+					_alloc.construct(pos + i, *first++);
 				_finish += n;
 			}
 			else
@@ -433,14 +513,15 @@ namespace ft
 
 		iterator erase(iterator position)
 		{
+			FT_PERF_SCOPE("vector::erase");
 			pointer pos = &(*position);
 			_alloc.destroy(pos);
 			while (pos != _finish - 1)
 			{
 				_alloc.construct(pos, *(pos + 1));
-				pos++;
+				_alloc.destroy(++pos);
 			}
-			_alloc.destroy(--_finish);
+			--_finish;
 			return (position);
 		}
 
@@ -448,6 +529,8 @@ namespace ft
 		{
 			if (first > last)
 				throw std::length_error("vector");
+			if (first == last)
+				return (first);
 			pointer f = &(*first);
 			pointer l = &(*last);
 			pointer tmp = f;
@@ -455,7 +538,10 @@ namespace ft
 				_alloc.destroy(tmp++);
 			tmp = f;
 			while (l != _finish)
-				_alloc.construct(tmp++, *l++);
+			{
+				_alloc.construct(tmp++, *l);
+				_alloc.destroy(l++);
+			}
 			_finish = tmp;
 			return (first);	
 		}
@@ -526,4 +612,6 @@ namespace ft
 	};
 }
 
+# include "vector_bool.hpp"
+
 #endif
@@ -0,0 +1,431 @@
+#ifndef VECTOR_BOOL_HPP
+# define VECTOR_BOOL_HPP
+
+# include "vector.hpp"
+# include "./iter/iterator_bit.hpp"
+
+namespace ft
+{
+/*
+* Packed vector<bool>: one bit per flag in bit_word words, so a billion
+* flags take 125 MB. operator[] and iterators return a bit_reference proxy.
+* Bits past size() are always zero, which lets assign/resize/insert/erase,
+* comparisons, count() and find_first() work a whole word at a time.
+*/
+	template <class Allocator>
+	class vector<bool, Allocator>
+	{
+	public:
+		typedef				bool											value_type;
+		typedef				Allocator										allocator_type;
+		typedef				std::size_t										size_type;
+		typedef				std::ptrdiff_t									difference_type;
+		typedef				ft::bit_reference								reference;
+		typedef				bool											const_reference;
+		typedef				ft::bit_iterator								iterator;
+		typedef				ft::bit_const_iterator							const_iterator;
+		typedef				ft::reverse_iterator<iterator>					reverse_iterator;
+		typedef				ft::reverse_iterator<const_iterator>			const_reverse_iterator;
+	private:
+		typedef typename	Allocator::template rebind<bit_word>::other	allocator_word;
+
+		enum { W = bit_word_size };
+
+		allocator_word	_alloc;
+		bit_word*		_words;
+		size_type		_size;
+		size_type		_cap;
+	public:
+//(1) empty container constructor (default constructor):
+		explicit vector(const Allocator& alloc = Allocator()):
+			_alloc(alloc),
+			_words(t_nullptr),
+			_size(0),
+			_cap(0)
+		{}
+//(2) fill constructor:
+		explicit vector(size_type n,
+						const bool& value = bool(),
+						const allocator_type& alloc = allocator_type()):
+			_alloc(alloc),
+			_words(t_nullptr),
+			_size(0),
+			_cap(0)
+		{
+			assign(n, value);
+		}
+//(3) range constructor:
+		template <class InputIterator>
+		vector(InputIterator first,
+				InputIterator last,
+				const allocator_type& alloc = allocator_type(),
+				typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type* = t_nullptr):
+			_alloc(alloc),
+			_words(t_nullptr),
+			_size(0),
+			_cap(0)
+		{
+			assign(first, last);
+		}
+//(4) copy constructor:
+		vector(const vector& x):
+			_alloc(x._alloc),
+			_words(t_nullptr),
+			_size(0),
+			_cap(0)
+		{
+			*this = x;
+		}
+//Destructor:
+		~vector()
+		{
+			if (_words)
+				_alloc.deallocate(_words, _cap);
+		}
+//Assign content:
+		vector& operator=(const vector& x)
+		{
+			if (this == &x)
+				return (*this);
+			clear();
+			reserve(x._size);
+			for (size_type i = 0; i < _words_for(x._size); i++)
+				_words[i] = x._words[i];
+			_size = x._size;
+			return (*this);
+		}
+
+		template <class InputIterator>
+		void assign(InputIterator first,
+					InputIterator last,
+					typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type* = t_nullptr)
+		{
+			clear();
+			insert(end(), first, last);
+		}
+
+		void assign(size_type n, const bool& x)
+		{
+			clear();
+			reserve(n);
+			_fill(0, n, x);
+			_size = n;
+		}
+
+		allocator_type get_allocator() const { return allocator_type(_alloc); }
+
+//iterators:
+		iterator begin() { return iterator(_words, 0); }
+		const_iterator begin() const { return const_iterator(_words, 0); }
+		iterator end() { return begin() + _size; }
+		const_iterator end() const { return begin() + _size; }
+		reverse_iterator rbegin() { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+		reverse_iterator rend() { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+//capacity:
+		size_type size() const { return _size; }
+		size_type capacity() const { return _cap * W; }
+		bool empty() const { return _size == 0; }
+		size_type memory_usage() const { return _cap * sizeof(bit_word); }
+
+		size_type max_size() const
+		{
+			size_type n = allocator_word().max_size();
+			return n > size_type(-1) / W ? size_type(-1) : n * W;
+		}
+
+		void resize(size_type sz, bool c = false)
+		{
+			if (sz > max_size())
+				throw (std::length_error("vector"));
+			if (sz < _size)
+				_fill(sz, _size, false);
+			else
+			{
+				if (sz > capacity())
+					reserve(sz > 2 * capacity() ? sz : 2 * capacity());
+				_fill(_size, sz, c);
+			}
+			_size = sz;
+		}
+
+		void reserve(size_type n)
+		{
+			if (n > max_size())
+				throw (std::length_error("vector"));
+			if (n <= capacity())
+				return ;
+			size_type cap = _words_for(n);
+			bit_word* words = _alloc.allocate(cap);
+			size_type used = _words_for(_size);
+			for (size_type i = 0; i < used; i++)
+				words[i] = _words[i];
+			for (size_type i = used; i < cap; i++)
+				words[i] = 0;
+			if (_words)
+				_alloc.deallocate(_words, _cap);
+			_words = words;
+			_cap = cap;
+		}
+
+//element access:
+		reference operator[](size_type n) { return reference(_words + n / W, bit_word(1) << (n % W)); }
+		const_reference operator[](size_type n) const { return (_words[n / W] >> (n % W)) & 1; }
+		reference front() { return (*this)[0]; }
+		const_reference front() const { return (*this)[0]; }
+		reference back() { return (*this)[_size - 1]; }
+		const_reference back() const { return (*this)[_size - 1]; }
+
+		reference at(size_type n)
+		{
+			if (n >= size())
+				throw (std::length_error("vector"));
+			return ((*this)[n]);
+		}
+
+		const_reference at(size_type n) const
+		{
+			if (n >= size())
+				throw (std::length_error("vector"));
+			return ((*this)[n]);
+		}
+
+//bit kernels:
+		size_type count() const
+		{
+			size_type n = 0;
+			for (size_type i = 0; i < _words_for(_size); i++)
+				n += ft::popcount(_words[i]);
+			return n;
+		}
+
+		/* index of the first set bit, size() if there is none */
+		size_type find_first() const { return _find_from(0); }
+
+		/* index of the first set bit after pos, size() if there is none */
+		size_type find_next(size_type pos) const { return _find_from(pos + 1); }
+
+		void flip()
+		{
+			for (size_type i = 0; i < _words_for(_size); i++)
+				_words[i] = ~_words[i];
+			_fill(_size, _words_for(_size) * W, false);
+		}
+
+//Modifiers:
+		void push_back(const bool& x)
+		{
+			if (_size == capacity())
+				reserve(_size ? 2 * _size : size_type(W));
+			if (x)
+				(*this)[_size] = true;
+			++_size;
+		}
+
+		void pop_back()
+		{
+			(*this)[--_size] = false;
+		}
+
+		iterator insert(iterator position, const bool& x)
+		{
+			size_type idx = position - begin();
+			insert(position, 1, x);
+			return begin() + idx;
+		}
+
+		void insert(iterator position, size_type n, const bool& x)
+		{
+			size_type idx = _open(position, n);
+			_fill(idx, idx + n, x);
+		}
+
+		template <class InputIterator>
+		void insert(iterator position,
+					InputIterator first,
+					InputIterator last,
+					typename enable_if<!is_integral<InputIterator>::value>::type* = 0)
+		{
+			size_type idx = _open(position, ft::distance(first, last));
+			for (; first != last; ++first)
+				(*this)[idx++] = bool(*first);
+		}
+
+		iterator erase(iterator position)
+		{
+			return erase(position, position + 1);
+		}
+
+		iterator erase(iterator first, iterator last)
+		{
+			size_type idx = first - begin();
+			size_type n = last - first;
+			_move(idx, idx + n, _size - idx - n);
+			_fill(_size - n, _size, false);
+			_size -= n;
+			return begin() + idx;
+		}
+
+		void swap(vector& x)
+		{
+			allocator_word save_alloc = x._alloc;
+			bit_word* save_words = x._words;
+			size_type save_size = x._size;
+			size_type save_cap = x._cap;
+			x._alloc = _alloc;
+			x._words = _words;
+			x._size = _size;
+			x._cap = _cap;
+			_alloc = save_alloc;
+			_words = save_words;
+			_size = save_size;
+			_cap = save_cap;
+		}
+
+		static void swap(reference x, reference y)
+		{
+			bool tmp = x;
+			x = y;
+			y = tmp;
+		}
+
+		void clear()
+		{
+			for (size_type i = 0; i < _words_for(_size); i++)
+				_words[i] = 0;
+			_size = 0;
+		}
+
+	private:
+		static size_type _words_for(size_type n) { return (n + W - 1) / W; }
+
+		/* n bits starting at bit i, in the low bits of the result (n <= W) */
+		bit_word _get(size_type i, size_type n) const
+		{
+			size_type w = i / W;
+			size_type off = i % W;
+			bit_word v = _words[w] >> off;
+			if (off + n > W)
+				v |= _words[w + 1] << (W - off);
+			return n < W ? v & ((bit_word(1) << n) - 1) : v;
+		}
+
+		void _put(size_type i, bit_word v, size_type n)
+		{
+			size_type w = i / W;
+			size_type off = i % W;
+			bit_word mask = n < W ? (bit_word(1) << n) - 1 : ~bit_word(0);
+			v &= mask;
+			_words[w] = (_words[w] & ~(mask << off)) | (v << off);
+			if (off + n > W)
+				_words[w + 1] = (_words[w + 1] & ~(mask >> (W - off))) | (v >> (W - off));
+		}
+
+		/* memmove for bit ranges, one word per step */
+		void _move(size_type dst, size_type src, size_type n)
+		{
+			if (dst < src)
+				for (size_type k = 0; k < n; k += W)
+				{
+					size_type m = n - k < size_type(W) ? n - k : size_type(W);
+					_put(dst + k, _get(src + k, m), m);
+				}
+			else if (dst > src)
+				for (size_type k = n; k > 0; )
+				{
+					size_type m = k < size_type(W) ? k : size_type(W);
+					k -= m;
+					_put(dst + k, _get(src + k, m), m);
+				}
+		}
+
+		void _fill(size_type first, size_type last, bool x)
+		{
+			if (first >= last)
+				return ;
+			size_type fw = first / W;
+			size_type lw = (last - 1) / W;
+			bit_word fmask = ~bit_word(0) << (first % W);
+			bit_word lmask = ~bit_word(0) >> (W - 1 - (last - 1) % W);
+			if (fw == lw)
+				fmask &= lmask;
+			_words[fw] = x ? _words[fw] | fmask : _words[fw] & ~fmask;
+			if (fw == lw)
+				return ;
+			for (size_type i = fw + 1; i < lw; i++)
+				_words[i] = x ? ~bit_word(0) : 0;
+			_words[lw] = x ? _words[lw] | lmask : _words[lw] & ~lmask;
+		}
+
+		/* makes a gap of n zero bits at position, returns its index */
+		size_type _open(iterator position, size_type n)
+		{
+			size_type idx = position - begin();
+			if (_size + n > max_size())
+				throw (std::length_error("vector"));
+			if (_size + n > capacity())
+				reserve(_size + n > 2 * capacity() ? _size + n : 2 * capacity());
+			_move(idx + n, idx, _size - idx);
+			_fill(idx, idx + n, false);
+			_size += n;
+			return idx;
+		}
+
+		size_type _find_from(size_type i) const
+		{
+			if (i >= _size)
+				return _size;
+			size_type w = i / W;
+			size_type used = _words_for(_size);
+			bit_word v = _words[w] & (~bit_word(0) << (i % W));
+			while (v == 0)
+			{
+				if (++w == used)
+					return _size;
+				v = _words[w];
+			}
+			return w * W + ft::count_trailing_zeros(v);
+		}
+
+	public:
+//Non-member function overloads
+		friend bool operator==(const vector& x, const vector& y)
+		{
+			if (x._size != y._size)
+				return false;
+			for (size_type i = 0; i < _words_for(x._size); i++)
+				if (x._words[i] != y._words[i])
+					return false;
+			return true;
+		}
+
+		friend bool operator!=(const vector& x, const vector& y)
+		{
+			return (!(x == y));
+		}
+
+		friend bool operator< (const vector& x, const vector& y)
+		{
+			return ft::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end());
+		}
+
+		friend bool operator> (const vector& x, const vector& y)
+		{
+			return (y < x);
+		}
+
+		friend bool operator<=(const vector& x, const vector& y)
+		{
+			return !(y < x);
+		}
+
+		friend bool operator>=(const vector& x, const vector& y)
+		{
+			return !(x < y);
+		}
+	};
+}
+
+#endif